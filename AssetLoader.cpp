@@ -0,0 +1,223 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include "Texture.h"
+#include "AssetLoader.h"
+#include "Audio.h"
+#include "Profiler.h"
+using namespace std;
+
+AssetLoader::AssetLoader() {
+    decodedMutex=SDL_CreateMutex();
+    fontMutex=SDL_CreateMutex();
+    SDL_AtomicSet(&nextJob, 0);
+}
+
+AssetLoader::~AssetLoader() {
+    stop();
+    SDL_DestroyMutex(decodedMutex);
+    SDL_DestroyMutex(fontMutex);
+}
+
+void AssetLoader::add(AssetKind kind, void *target, const std::string &path, int fontSize, AssetGroup group) {
+    Job job;
+    job.kind=kind;
+    job.group=group;
+    job.path=path;
+    job.fontSize=fontSize;
+    job.target=target;
+    jobs.push_back(job);
+    groupRemaining[group]++;
+}
+
+void AssetLoader::addFont(TTF_Font **font, const std::string &path, int size, AssetGroup group) {
+    add(ASSET_FONT, font, path, size, group);
+}
+void AssetLoader::addImage(LTexture *texture, const std::string &path, AssetGroup group) {
+    add(ASSET_IMAGE, texture, path, 0, group);
+}
+void AssetLoader::addMusic(Mix_Music **music, const std::string &path, AssetGroup group) {
+    add(ASSET_MUSIC, music, path, 0, group);
+}
+void AssetLoader::addSound(Mix_Chunk **sound, const std::string &path, AssetGroup group) {
+    add(ASSET_SOUND, sound, path, 0, group);
+}
+
+bool AssetLoader::start() {
+    // Workers take jobs in queue order, so the menu group is decoded first
+    stable_sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) { return a.group<b.group; });
+    decoded.reserve(jobs.size());
+    handOver.reserve(jobs.size());
+
+    int workerCount=max(1, min({SDL_GetCPUCount(), MAX_ASSET_WORKERS, int(jobs.size())}));
+    for (int i=0; i<workerCount; i++) {
+        SDL_Thread *thread=SDL_CreateThread(worker, "AssetLoader", this);
+        if (thread==nullptr) {
+            cout << "Unable to create asset loading thread. " << SDL_GetError() << endl;
+            break;
+        }
+        workers.push_back(thread);
+    }
+    if (workers.empty()) {
+        worker(this); // Load everything here instead
+    }
+    return true;
+}
+
+int AssetLoader::worker(void *data) {
+    AssetLoader *loader=static_cast<AssetLoader*>(data);
+    int index;
+    while ((index=SDL_AtomicAdd(&loader->nextJob, 1))<int(loader->jobs.size())) {
+        loader->decode(loader->jobs[index]);
+        SDL_LockMutex(loader->decodedMutex);
+        loader->decoded.push_back(index);
+        SDL_UnlockMutex(loader->decodedMutex);
+    }
+    return 0;
+}
+
+// Runs on a worker, nothing here may touch the renderer
+void AssetLoader::decode(Job &job) {
+    PROFILE_SPAN_DETAIL("decodeAsset", job.path.c_str());
+    switch (job.kind) {
+    case ASSET_FONT:
+        SDL_LockMutex(fontMutex);
+        job.result=TTF_OpenFont(job.path.c_str(), job.fontSize);
+        if (job.result==nullptr) job.error=TTF_GetError();
+        SDL_UnlockMutex(fontMutex);
+        break;
+    case ASSET_IMAGE:
+        job.result=IMG_Load(job.path.c_str());
+        if (job.result==nullptr) job.error=IMG_GetError();
+        break;
+    case ASSET_MUSIC:
+        lockMixer(); // Shared with the render thread playing sounds
+        job.result=Mix_LoadMUS(job.path.c_str());
+        if (job.result==nullptr) job.error=Mix_GetError();
+        unlockMixer();
+        break;
+    case ASSET_SOUND:
+        lockMixer();
+        job.result=Mix_LoadWAV(job.path.c_str());
+        if (job.result==nullptr) job.error=Mix_GetError();
+        unlockMixer();
+        break;
+    }
+}
+
+// Runs on the render thread
+void AssetLoader::deliver(Job &job) {
+    PROFILE_SPAN_DETAIL("deliverAsset", job.path.c_str());
+    if (job.result==nullptr) {
+        cout << "Failed to load " << job.path << ". " << job.error << endl;
+        anyFailed=true;
+    }
+    else {
+        switch (job.kind) {
+        case ASSET_FONT:
+            *static_cast<TTF_Font**>(job.target)=static_cast<TTF_Font*>(job.result);
+            break;
+        case ASSET_IMAGE: {
+            SDL_Surface *surface=static_cast<SDL_Surface*>(job.result);
+            if (!static_cast<LTexture*>(job.target)->loadFromSurface(surface)) {
+                cout << "Failed to load " << job.path << "." << endl;
+                anyFailed=true;
+            }
+            SDL_FreeSurface(surface);
+            break;
+        }
+        case ASSET_MUSIC:
+            *static_cast<Mix_Music**>(job.target)=static_cast<Mix_Music*>(job.result);
+            break;
+        case ASSET_SOUND:
+            *static_cast<Mix_Chunk**>(job.target)=static_cast<Mix_Chunk*>(job.result);
+            break;
+        }
+        job.result=nullptr;
+    }
+    job.done=true;
+    doneCount++;
+    groupRemaining[job.group]--;
+}
+
+void AssetLoader::poll() {
+    SDL_LockMutex(decodedMutex);
+    handOver.swap(decoded);
+    SDL_UnlockMutex(decodedMutex);
+    for (int index : handOver) {
+        deliver(jobs[index]);
+    }
+    handOver.clear();
+
+    // Every job is in, the workers have nothing left to do
+    if (finished()) {
+        for (SDL_Thread *thread : workers) SDL_WaitThread(thread, nullptr);
+        workers.clear();
+    }
+}
+
+void AssetLoader::wait(AssetGroup group) {
+    while (!groupReady(group)) {
+        poll();
+        if (!groupReady(group)) SDL_Delay(1);
+    }
+}
+
+void AssetLoader::waitAll() {
+    while (!finished()) {
+        poll();
+        if (!finished()) SDL_Delay(1);
+    }
+}
+
+bool AssetLoader::groupReady(AssetGroup group) {
+    return groupRemaining[group]==0;
+}
+
+bool AssetLoader::finished() {
+    return doneCount==int(jobs.size());
+}
+
+bool AssetLoader::failed() {
+    return anyFailed;
+}
+
+float AssetLoader::progress() {
+    return jobs.empty() ? 1 : float(doneCount)/jobs.size();
+}
+
+void AssetLoader::stop() {
+    // Let the workers run out of jobs, then join them
+    SDL_AtomicSet(&nextJob, jobs.size());
+    for (SDL_Thread *thread : workers) SDL_WaitThread(thread, nullptr);
+    workers.clear();
+
+    // Free anything decoded but never handed over
+    SDL_LockMutex(decodedMutex);
+    for (int index : decoded) {
+        Job &job=jobs[index];
+        if (job.result==nullptr) continue;
+        switch (job.kind) {
+        case ASSET_FONT:
+            TTF_CloseFont(static_cast<TTF_Font*>(job.result));
+            break;
+        case ASSET_IMAGE:
+            SDL_FreeSurface(static_cast<SDL_Surface*>(job.result));
+            break;
+        case ASSET_MUSIC:
+            Mix_FreeMusic(static_cast<Mix_Music*>(job.result));
+            break;
+        case ASSET_SOUND:
+            Mix_FreeChunk(static_cast<Mix_Chunk*>(job.result));
+            break;
+        }
+        job.result=nullptr;
+    }
+    decoded.clear();
+    SDL_UnlockMutex(decodedMutex);
+}
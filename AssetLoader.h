@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include "Texture.h"
+
+// Most decoding threads, more just fight over the disk
+const int MAX_ASSET_WORKERS=4;
+
+// Assets the menu needs come first, the menu shows as soon as they are in
+enum AssetGroup {
+    ASSETS_MENU,
+    ASSETS_LEVELS,
+    TOTAL_ASSET_GROUP
+};
+
+enum AssetKind {
+    ASSET_FONT,
+    ASSET_IMAGE,
+    ASSET_MUSIC,
+    ASSET_SOUND
+};
+
+// Decodes files on worker threads, only the texture upload and the hand over happen on the render thread
+// Queue everything, start(), then poll() every frame until finished()
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&)=delete;
+    AssetLoader &operator=(const AssetLoader&)=delete;
+
+    // Queue an asset, the target is set when it's ready, all must be queued before start()
+    void addFont(TTF_Font **font, const std::string &path, int size, AssetGroup group);
+    void addImage(LTexture *texture, const std::string &path, AssetGroup group);
+    void addMusic(Mix_Music **music, const std::string &path, AssetGroup group);
+    void addSound(Mix_Chunk **sound, const std::string &path, AssetGroup group);
+
+    // Start the workers
+    bool start();
+
+    // Hand over whatever the workers have finished, call on the render thread
+    void poll();
+
+    // Poll until a group is done, for callers that can't go on without it
+    void wait(AssetGroup group);
+    void waitAll();
+
+    bool groupReady(AssetGroup group);
+    bool finished();
+    bool failed(); // Some asset could not be loaded
+    float progress();
+
+    // Stop the workers and throw away what was not handed over yet
+    void stop();
+
+private:
+    struct Job {
+        AssetKind kind;
+        AssetGroup group;
+        std::string path;
+        int fontSize=0;
+        void *target=nullptr;       // TTF_Font**, LTexture*, Mix_Music** or Mix_Chunk**
+        void *result=nullptr;       // Decoded asset, an SDL_Surface for images
+        std::string error;
+        bool done=false;
+    };
+
+    std::vector<Job> jobs;
+    std::vector<int> decoded;       // Jobs waiting for poll(), guarded by decodedMutex
+    std::vector<int> handOver;      // Swapped with decoded so poll() holds the lock briefly
+    std::vector<SDL_Thread*> workers;
+    SDL_mutex *decodedMutex;
+    SDL_mutex *fontMutex;           // FreeType is not safe to open files on from several threads, audio uses lockMixer
+    SDL_atomic_t nextJob;
+    int doneCount=0;
+    int groupRemaining[TOTAL_ASSET_GROUP]={};
+    bool anyFailed=false;
+
+    void add(AssetKind kind, void *target, const std::string &path, int fontSize, AssetGroup group);
+    void decode(Job &job);
+    void deliver(Job &job);
+    static int worker(void *data);
+};
+
+extern AssetLoader assetLoader;
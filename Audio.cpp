@@ -0,0 +1,95 @@
+#include <SDL_mixer.h>
+#include "Audio.h"
+
+extern Mix_Music *gameThemeSong;
+extern Mix_Music *fnafSong;
+extern Mix_Music *jojoSong;
+extern Mix_Chunk *deathSound;
+
+bool audioEnabled=false;
+
+static MusicTrack currentTrack=MUSIC_NONE;
+static bool musicLoops=false;
+static double musicPosition=0;
+
+static SDL_mutex *mixerMutex=SDL_CreateMutex();
+
+static Mix_Music *trackMusic(MusicTrack track) {
+    switch (track) {
+    case MUSIC_THEME:
+        return gameThemeSong;
+    case MUSIC_FNAF:
+        return fnafSong;
+    case MUSIC_ROUNDABOUT:
+        return jojoSong;
+    default:
+        return nullptr;
+    }
+}
+
+static double trackLength(MusicTrack track) {
+    switch (track) {
+    case MUSIC_FNAF:
+        return FNAF_SONG_LENGTH;
+    case MUSIC_ROUNDABOUT:
+        return ROUNDABOUT_LENGTH;
+    default:
+        return 0;
+    }
+}
+
+void playMusic(MusicTrack track, int loops) {
+    currentTrack=track;
+    musicLoops=(loops==-1);
+    musicPosition=0;
+    if (audioEnabled && trackMusic(track)!=nullptr) {
+        lockMixer();
+        Mix_PlayMusic(trackMusic(track), loops);
+        unlockMixer();
+    }
+}
+
+static Mix_Chunk *soundChunk(SoundEffect sound) {
+    switch (sound) {
+    case SOUND_DEATH:
+        return deathSound;
+    default:
+        return nullptr;
+    }
+}
+
+void playSound(SoundEffect sound) {
+    if (audioEnabled && soundChunk(sound)!=nullptr) {
+        lockMixer();
+        Mix_PlayChannel(-1, soundChunk(sound), 0);
+        unlockMixer();
+    }
+}
+
+bool isMusicPlaying() {
+    return currentTrack!=MUSIC_NONE;
+}
+
+double musicTime() {
+    return musicPosition;
+}
+
+void advanceMusic(double deltaTime) {
+    if (currentTrack==MUSIC_NONE || musicLoops) return;
+    musicPosition+=deltaTime;
+    if (musicPosition>=trackLength(currentTrack)) currentTrack=MUSIC_NONE;
+}
+
+void resetMusic() {
+    currentTrack=MUSIC_NONE;
+    musicLoops=false;
+    musicPosition=0;
+}
+
+void lockMixer() {
+    SDL_LockMutex(mixerMutex);
+}
+
+void unlockMixer() {
+    SDL_UnlockMutex(mixerMutex);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Music that gameplay depends on (Five Nights ends when its song does, the Jojo cutscene lasts as long as
+// Roundabout) is tracked with a clock that advances with simulation ticks, so a level plays the same
+// with or without an audio device. The real song is played alongside when audio is enabled.
+
+enum MusicTrack {
+    MUSIC_NONE,
+    MUSIC_THEME,
+    MUSIC_FNAF,
+    MUSIC_ROUNDABOUT
+};
+
+enum SoundEffect {
+    SOUND_DEATH
+};
+
+// Song lengths in seconds, only needed for songs that don't loop
+const double FNAF_SONG_LENGTH=10.24;
+const double ROUNDABOUT_LENGTH=23.82;
+
+// Mixer is open and songs are loaded (false when headless)
+extern bool audioEnabled;
+
+// Start a song, loops is -1 to loop forever or 0 to play once
+void playMusic(MusicTrack track, int loops);
+
+// Play a sound effect once on a free channel
+void playSound(SoundEffect sound);
+
+// Check if a song is still playing on the simulation clock
+bool isMusicPlaying();
+
+// Seconds the current song has played on the simulation clock
+double musicTime();
+
+// Move the song forward by one tick
+void advanceMusic(double deltaTime);
+
+// Forget the current song without touching the mixer
+void resetMusic();
+
+// The mixer is not safe to use from several threads at once, asset workers hold this while they decode audio
+// and every mixer call above takes it too
+void lockMixer();
+void unlockMixer();
@@ -0,0 +1,223 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <SDL.h>
+#include "Texture.h"
+#include "Player.h"
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "Rendering.h"
+#include "Simulation.h"
+#include "Timestep.h"
+#include "Replay.h"
+#include "Headless.h"
+#include "Audio.h"
+#include "TextCache.h"
+#include "FramePacer.h"
+#include "Enums.h"
+#include "Benchmark.h"
+
+extern SDL_Window *gWindow;
+extern SDL_Renderer *gRenderer;
+extern Background selectedBG;
+extern LTexture backgroundTexture[];
+
+extern const int SCREEN_WIDTH;
+extern const int SCREEN_HEIGHT;
+
+void displayTextInLevel(Player &cube, std::vector<Block> &blocks, GameStatus currentStatus, GameSetting currentSetting,
+                        const std::string &levelName, const int &levelIndex);
+
+// Parts of a frame, in report order
+enum BenchmarkPhase {
+    PHASE_FRAME,
+    PHASE_SIMULATION,
+    PHASE_MOVE,
+    PHASE_INTERACT,
+    PHASE_PUSHABLES,
+    PHASE_RENDER_LEVEL,
+    PHASE_TEXT,
+    PHASE_PRESENT,
+    TOTAL_PHASE
+};
+
+const char *phaseName[TOTAL_PHASE]={"frame", "simulation", "move", "interact", "pushables", "renderLevel", "text", "present"};
+
+struct LevelResult {
+    std::string name;
+    int deaths=0;
+    std::vector<double> samples[TOTAL_PHASE]; // Milliseconds, one per frame
+};
+
+static double millisecondsSince(Uint64 start) {
+    return double(SDL_GetPerformanceCounter()-start)*1000/SDL_GetPerformanceFrequency();
+}
+
+// Value below which the given fraction of the samples fall, samples get sorted
+static double percentile(std::vector<double> &samples, double fraction) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t index=size_t(fraction*(samples.size()-1)+0.5);
+    return samples[index];
+}
+
+// Slowest sample, whether or not percentile sorted the samples yet
+static double maximum(std::vector<double> &samples) {
+    if (samples.empty()) return 0;
+    return *std::max_element(samples.begin(), samples.end());
+}
+
+// Level names end up in the file as they are, quotes and backslashes have to be escaped
+static void writeJsonString(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (char c : text) {
+        if (c=='"' || c=='\\') out << '\\' << c;
+        else if ((unsigned char)c<0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+static void writeCsv(std::ostream &out, std::vector<LevelResult> &results) {
+    out << "level,phase,frames,deaths,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (auto &result : results) {
+        for (int phase=0; phase<TOTAL_PHASE; phase++) {
+            std::vector<double> &samples=result.samples[phase];
+            double p50=percentile(samples, 0.5), p95=percentile(samples, 0.95), p99=percentile(samples, 0.99);
+            double max=maximum(samples);
+            out << '"' << result.name << "\"," << phaseName[phase] << ',' << samples.size() << ',' << result.deaths << ','
+                << p50 << ',' << p95 << ',' << p99 << ',' << max << '\n';
+        }
+    }
+}
+
+static void writeJson(std::ostream &out, std::vector<LevelResult> &results, long long ticks) {
+    out << "{\n  \"tickRate\": " << tickRate << ",\n  \"ticks\": " << ticks << ",\n  \"levels\": [\n";
+    for (size_t i=0; i<results.size(); i++) {
+        LevelResult &result=results[i];
+        out << "    {\"name\": ";
+        writeJsonString(out, result.name);
+        out << ", \"deaths\": " << result.deaths << ", \"phases\": {";
+        for (int phase=0; phase<TOTAL_PHASE; phase++) {
+            std::vector<double> &samples=result.samples[phase];
+            double p50=percentile(samples, 0.5), p95=percentile(samples, 0.95), p99=percentile(samples, 0.99);
+            double max=maximum(samples);
+            out << (phase>0 ? ", " : "") << '"' << phaseName[phase] << "\": {"
+                << "\"p50\": " << p50 << ", \"p95\": " << p95 << ", \"p99\": " << p99 << ", \"max\": " << max << '}';
+        }
+        out << "}}" << (i+1<results.size() ? "," : "") << '\n';
+    }
+    out << "  ]\n}\n";
+}
+
+int runBenchmark(int argc, char *argv[]) {
+    long long ticks=(argc>=3 ? atoll(argv[2]) : 10*DEFAULT_TICK_RATE);
+    unsigned int seed=(argc>=4 ? strtoul(argv[3], nullptr, 10) : 1);
+    std::string outputPath=(argc>=5 ? argv[4] : "");
+    if (ticks<=0) {
+        std::cerr << "Tick count must be positive." << std::endl;
+        return 1;
+    }
+
+    audioEnabled=false; // Keep the mixer out of the measurements
+    setPacing(gRenderer, gWindow, PACING_UNLIMITED); // Measure the frame, not the wait for the display
+
+    std::vector<LevelResult> results;
+    bool quit=false;
+    for (int levelIndex=0; levelIndex<ALL_LEVELS && !quit; levelIndex++) {
+        const std::string &name=levelName[levelIndex];
+        if (!std::ifstream(levelPath(name)).is_open()) {
+            std::cerr << name << ": no level file, skipped" << std::endl; // The Hub, checked first to keep the console output clean
+            continue;
+        }
+        if (!startLevel(name, seed)) {
+            std::cerr << name << ": failed to load" << std::endl;
+            continue;
+        }
+
+        LevelResult result;
+        result.name=name;
+        for (auto &samples : result.samples) samples.reserve(ticks);
+
+        Player cube;
+        GameStatus currentStatus=PLAYING;
+        bool dead=false;
+        unsigned int inputState=seed;
+        uint8_t keys=0;
+        SDL_FRect backgroundRect={0, 0, float(SCREEN_WIDTH), float(SCREEN_HEIGHT)};
+        unsigned long long firstFrameMisses=0;
+        for (long long tick=0; tick<ticks && !quit; tick++) {
+            Uint64 frameStart=SDL_GetPerformanceCounter();
+
+            // Keep the window responsive, input comes from the script
+            SDL_Event e;
+            while (SDL_PollEvent(&e)) {
+                if (e.type==SDL_QUIT) quit=true;
+            }
+
+            keys=scriptedKeys(tick, inputState, keys);
+            applyInputKeys(cube, keys);
+            TickTimes times;
+            Uint64 start=SDL_GetPerformanceCounter();
+            simulateTick(cube, currentStatus, dead, tickLength(), &times);
+            result.samples[PHASE_SIMULATION].push_back(millisecondsSince(start));
+            result.samples[PHASE_MOVE].push_back(times.move*1000);
+            result.samples[PHASE_INTERACT].push_back(times.interact*1000);
+            result.samples[PHASE_PUSHABLES].push_back(times.pushables*1000);
+
+            SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+            SDL_RenderClear(gRenderer);
+            backgroundTexture[selectedBG].render(backgroundRect);
+
+            start=SDL_GetPerformanceCounter();
+            renderLevel(blocks, pushableBlocks, spikes, jumpOrbs, jumpPads, 1.0);
+            result.samples[PHASE_RENDER_LEVEL].push_back(millisecondsSince(start));
+            cube.render(1.0);
+
+            start=SDL_GetPerformanceCounter();
+            displayTextInLevel(cube, blocks, PLAYING, SETTING_BG, name, levelIndex);
+            result.samples[PHASE_TEXT].push_back(millisecondsSince(start));
+            renderLevelOverlay(cube, name);
+
+            start=SDL_GetPerformanceCounter();
+            SDL_RenderPresent(gRenderer);
+            result.samples[PHASE_PRESENT].push_back(millisecondsSince(start));
+            textCache.trim();
+
+            // Everything after the first frame should be drawn from the cache
+            if (tick==0) firstFrameMisses=textCache.getStats().misses;
+
+            // Start the level over on death or exit, every frame stays on this level
+            if (dead || currentStatus!=PLAYING) {
+                if (dead) result.deaths++;
+                dead=false;
+                currentStatus=PLAYING;
+                startLevel(name, seed);
+                cube.reset();
+            }
+
+            result.samples[PHASE_FRAME].push_back(millisecondsSince(frameStart));
+        }
+        const TextCacheStats &textStats=textCache.getStats();
+        std::cerr << name << ": " << textStats.misses-firstFrameMisses << " text rasterized after the first frame, "
+                  << textStats.bytesResident << " bytes of text cached" << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    if (outputPath=="") {
+        writeCsv(std::cout, results);
+        return 0;
+    }
+    std::ofstream file(outputPath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write benchmark results: " << outputPath << std::endl;
+        return 1;
+    }
+    bool json=outputPath.size()>=5 && outputPath.compare(outputPath.size()-5, 5, ".json")==0;
+    if (json) writeJson(file, results, ticks);
+    else writeCsv(file, results);
+    return 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Frame time benchmark: every level in the window with scripted input, one tick and one frame at a time
+// "Die to Win" --benchmark [ticks] [seed] [output.csv|output.json]   (CSV to the console when no file is given)
+// Reports p50/p95/p99/max of the frame and of each part of it, in milliseconds
+int runBenchmark(int argc, char *argv[]);
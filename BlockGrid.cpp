@@ -0,0 +1,97 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "BlockGrid.h"
+
+struct BlockGrid {
+    const std::vector<Block> *source=nullptr;
+    unsigned int revision=0;
+    size_t indexedCount=0;                      // Blocks after this were added during play
+    std::vector<std::vector<size_t>> cells;     // Static blocks covering each tile
+    std::vector<size_t> dynamicBlocks;          // Blocks that moved since they were indexed
+    std::vector<char> isDynamic;
+    std::vector<unsigned int> visitStamp;       // Skip blocks already found in an earlier cell
+    unsigned int currentStamp=0;
+};
+static BlockGrid grid;
+
+// Tile column/row of a position, clamped to the grid so objects outside the screen land on the border
+// Tiles start at the same offsets as in loadLevel
+static int cellColumn(double x) {
+    double col=floor((x+TILE_SIZE*11/18)/TILE_SIZE);
+    return col<0 ? 0 : (col>LEVEL_WIDTH-1 ? LEVEL_WIDTH-1 : int(col));
+}
+static int cellRow(double y) {
+    double row=floor((y+TILE_SIZE*9/18)/TILE_SIZE);
+    return row<0 ? 0 : (row>LEVEL_HEIGHT-1 ? LEVEL_HEIGHT-1 : int(row));
+}
+
+// Index every block of the current level
+static void buildBlockGrid(const std::vector<Block> &blocks) {
+    grid.source=&blocks;
+    grid.revision=levelRevision;
+    grid.indexedCount=blocks.size();
+    grid.cells.assign(LEVEL_WIDTH*LEVEL_HEIGHT, std::vector<size_t>());
+    grid.dynamicBlocks.clear();
+    grid.isDynamic.assign(blocks.size(), 0);
+    grid.visitStamp.assign(blocks.size(), 0);
+    grid.currentStamp=0;
+
+    for (size_t i=0; i<blocks.size(); i++) {
+        const SDL_FRect &hitbox=blocks[i].getHitbox();
+        int col0=cellColumn(hitbox.x), col1=cellColumn(hitbox.x+hitbox.w);
+        int row0=cellRow(hitbox.y), row1=cellRow(hitbox.y+hitbox.h);
+        for (int row=row0; row<=row1; row++) {
+            for (int col=col0; col<=col1; col++) {
+                grid.cells[row*LEVEL_WIDTH+col].push_back(i);
+            }
+        }
+    }
+}
+
+void findNearbyBlocks(const std::vector<Block> &blocks, double left, double top, double right, double bottom,
+                      std::vector<size_t> &result) {
+    // Rebuild after a level load, or if the vector isn't the one that was indexed
+    if (grid.source!=&blocks || grid.revision!=levelRevision || blocks.size()<grid.indexedCount) {
+        buildBlockGrid(blocks);
+    }
+
+    result.clear();
+    if (++grid.currentStamp==0) { // Stamp wrapped around, old stamps could match again
+        std::fill(grid.visitStamp.begin(), grid.visitStamp.end(), 0);
+        grid.currentStamp=1;
+    }
+
+    int col0=std::max(cellColumn(left)-BLOCK_GRID_MARGIN, 0), col1=std::min(cellColumn(right)+BLOCK_GRID_MARGIN, LEVEL_WIDTH-1);
+    int row0=std::max(cellRow(top)-BLOCK_GRID_MARGIN, 0), row1=std::min(cellRow(bottom)+BLOCK_GRID_MARGIN, LEVEL_HEIGHT-1);
+    for (int row=row0; row<=row1; row++) {
+        for (int col=col0; col<=col1; col++) {
+            for (size_t i : grid.cells[row*LEVEL_WIDTH+col]) {
+                if (grid.isDynamic[i] || grid.visitStamp[i]==grid.currentStamp) continue;
+                grid.visitStamp[i]=grid.currentStamp;
+                result.push_back(i);
+            }
+        }
+    }
+
+    // Moved blocks and blocks added during play are always checked, there are only a few of them
+    result.insert(result.end(), grid.dynamicBlocks.begin(), grid.dynamicBlocks.end());
+    for (size_t i=grid.indexedCount; i<blocks.size(); i++) result.push_back(i);
+
+    // Keep the order of a full scan, collision response depends on it
+    std::sort(result.begin(), result.end());
+}
+
+void markBlockMoved(const Block &block) {
+    // Blocks of other vectors (level cache, level compiler) and blocks moved before the grid is built don't matter
+    if (grid.source==nullptr || grid.revision!=levelRevision) return;
+    const std::vector<Block> &blocks=*grid.source;
+    if (blocks.empty() || &block<blocks.data() || &block>=blocks.data()+blocks.size()) return;
+
+    size_t i=&block-blocks.data();
+    if (i>=grid.indexedCount || grid.isDynamic[i]) return;
+    grid.isDynamic[i]=1;
+    grid.dynamicBlocks.push_back(i);
+}
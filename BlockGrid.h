@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include "LevelObjs.h"
+
+// Broadphase for block collision: blocks are indexed by the level tiles they cover when the level loads,
+// so a collision check only visits the blocks around the player instead of the whole level.
+// Blocks that move afterwards (moving blocks, offset blocks) and blocks added during play are kept
+// in a small dynamic set that every query includes.
+
+// Cells around a query that are also searched, covers positions pushed out of the query by earlier collisions
+const int BLOCK_GRID_MARGIN=2;
+
+// Get the indices of every block that can touch an area, in ascending order (same order as looping over blocks)
+void findNearbyBlocks(const std::vector<Block> &blocks, double left, double top, double right, double bottom,
+                      std::vector<size_t> &result);
+
+// Tell the grid a block is no longer where it was indexed
+void markBlockMoved(const Block &block);
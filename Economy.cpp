@@ -0,0 +1,245 @@
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include "GlyphAtlas.h"
+#include "Economy.h"
+
+Money::Money(double amount) {
+    *this=normalized(amount, 0);
+}
+
+Money Money::normalized(double mantissa, int exponent) {
+    Money result;
+    if (mantissa==0) return result;
+    int shift;
+    result.mantissa=std::frexp(mantissa, &shift);
+    result.exponent=exponent+shift;
+    return result;
+}
+
+Money Money::operator+(const Money &other) const {
+    if (mantissa==0) return other;
+    if (other.mantissa==0) return *this;
+    const Money &big=(exponent>=other.exponent ? *this : other);
+    const Money &small=(exponent>=other.exponent ? other : *this);
+    int gap=big.exponent-small.exponent;
+    if (gap>64) return big; // Below the last bit of the bigger one
+    return normalized(big.mantissa+std::ldexp(small.mantissa, -gap), big.exponent);
+}
+
+Money Money::operator-(const Money &other) const {
+    Money negated=other;
+    negated.mantissa=-negated.mantissa;
+    return *this+negated;
+}
+
+Money Money::operator*(const Money &other) const {
+    return normalized(mantissa*other.mantissa, exponent+other.exponent);
+}
+
+Money Money::operator/(const Money &other) const {
+    if (other.mantissa==0) return Money();
+    return normalized(mantissa/other.mantissa, exponent-other.exponent);
+}
+
+int Money::compare(const Money &other) const {
+    int sign=(mantissa>0)-(mantissa<0);
+    int otherSign=(other.mantissa>0)-(other.mantissa<0);
+    if (sign!=otherSign) return sign<otherSign ? -1 : 1;
+    if (sign==0) return 0;
+    // Same sign and normalized, the bigger exponent is the bigger magnitude
+    if (exponent!=other.exponent) return exponent<other.exponent ? -sign : sign;
+    return (mantissa<other.mantissa ? -1 : mantissa>other.mantissa ? 1 : 0);
+}
+
+Money Money::floor() const {
+    if (mantissa==0 || exponent>=53) return *this; // No fraction bits left
+    if (exponent<=0) return Money(mantissa<0 ? -1 : 0);
+    return Money(std::floor(std::ldexp(mantissa, exponent)));
+}
+
+double Money::toDouble() const {
+    return std::ldexp(mantissa, exponent);
+}
+
+double Money::log10() const {
+    if (mantissa==0) return 0;
+    return std::log10(std::fabs(mantissa))+exponent*0.30102999566398120;
+}
+
+bool clickerUpgrade(TileType type, ClickerUpgrade &upgrade) {
+    switch (type) {
+    case TILE_1I2: upgrade=UPGRADE_POSITION; return true;
+    case TILE_1I3: upgrade=UPGRADE_GAIN; return true;
+    case TILE_1I4: upgrade=UPGRADE_PASSIVE; return true;
+    default: return false;
+    }
+}
+
+void Economy::reset() {
+    money=0;
+    gainPerHit=1;
+    passiveIncome=0;
+    spikeReleased=false;
+    for (int i=0; i<TOTAL_UPGRADE; i++) {
+        level[i]=0;
+        price[i]=5;
+        increment[i]=5;
+    }
+}
+
+void Economy::click() {
+    money+=gainPerHit;
+}
+
+void Economy::accrue(double seconds) {
+    if (seconds>0) money+=passiveIncome*seconds;
+}
+
+bool Economy::buy(ClickerUpgrade upgrade) {
+    int &count=level[upgrade];
+    if (count>=UPGRADE_MAX_LEVEL[upgrade] || money<price[upgrade]) return false;
+    money-=price[upgrade];
+
+    // Each upgrade's next increment comes from the price just paid, in whole amounts
+    if (upgrade==UPGRADE_POSITION) {
+        price[upgrade]*=(count==0 ? 100 : 4);
+    }
+    else if (upgrade==UPGRADE_GAIN) {
+        if (count==0) gainPerHit*=5;
+        else {
+            gainPerHit+=increment[upgrade];
+            increment[upgrade]=(price[upgrade]/count).floor();
+        }
+        price[upgrade]*=2;
+    }
+    else if (upgrade==UPGRADE_PASSIVE) {
+        if (count==0) passiveIncome=1;
+        else if (count==1) passiveIncome=5;
+        else {
+            passiveIncome+=increment[upgrade];
+            increment[upgrade]=(price[upgrade]/(2*count)).floor();
+        }
+        price[upgrade]*=(count<10 ? 3 : 2);
+    }
+    count++;
+    return true;
+}
+
+const char *formatMoney(char *buffer, const Money &amount, const char *prefix, const char *suffix) {
+    if (amount<Money(1e15)) return formatNumber(buffer, (long long)amount.floor().toDouble(), prefix, suffix);
+
+    // Three digits, rounded down so the counter never shows more than there is
+    double power=amount.log10();
+    long long exponent10=(long long)std::floor(power);
+    int digits=int(std::floor(std::pow(10.0, power-exponent10)*100+1e-9));
+    if (digits>=1000) {
+        digits=100;
+        exponent10++;
+    }
+    char head[TEXT_BUFFER_SIZE];
+    char *out=head, *end=head+TEXT_BUFFER_SIZE-6;
+    for (const char *ch=prefix; *ch && out<end; ch++) *out++=*ch;
+    *out++='0'+digits/100;
+    *out++='.';
+    *out++='0'+digits/10%10;
+    *out++='0'+digits%10;
+    *out++='e';
+    *out='\0';
+    return formatNumber(buffer, exponent10, head, suffix);
+}
+
+// The upgrade math as it was with 64 bit integers, for comparing while the numbers fit
+struct IntegerEconomy {
+    long long gainPerHit=1, passiveIncome=0;
+    long long level[TOTAL_UPGRADE]={}, price[TOTAL_UPGRADE]={5, 5, 5}, increment[TOTAL_UPGRADE]={5, 5, 5};
+
+    void buy(ClickerUpgrade upgrade) {
+        long long &count=level[upgrade], &value=price[upgrade];
+        if (upgrade==UPGRADE_POSITION) {
+            value*=(count==0 ? 100 : 4);
+        }
+        else if (upgrade==UPGRADE_GAIN) {
+            if (count==0) gainPerHit*=5;
+            else {
+                gainPerHit+=increment[upgrade];
+                increment[upgrade]=value/count;
+            }
+            value*=2;
+        }
+        else {
+            if (count==0) passiveIncome=1;
+            else if (count==1) passiveIncome=5;
+            else {
+                passiveIncome+=increment[upgrade];
+                increment[upgrade]=(value/count)/2;
+            }
+            value*=(count<10 ? 3 : 2);
+        }
+        count++;
+    }
+};
+
+bool testEconomy() {
+    // Whole amounts below 2^53 have to behave exactly like integers
+    std::mt19937_64 random(1);
+    for (int i=0; i<1000000; i++) {
+        uint64_t a=random()>>25, b=random()>>25;    // Sums fit in 2^40
+        uint64_t c=random()>>40, d=(random()>>40)+1; // Products fit in 2^48
+        Money ma=double(a), mb=double(b);
+        if (ma+mb!=Money(double(a+b)) ||
+            (ma-mb).toDouble()!=double(a)-double(b) ||
+            (Money(double(c))*Money(double(d))).toDouble()!=double(c*d) ||
+            (ma/Money(double(d))).floor().toDouble()!=double(a/d) ||
+            ma.compare(mb)!=(a<b ? -1 : a>b ? 1 : 0)) {
+            std::cout << "Money differs from integers at " << a << ", " << b << ", " << c << ", " << d << std::endl;
+            return false;
+        }
+    }
+
+    // Every upgrade level against the old integer math, the passive price outgrows an int halfway
+    Economy economy;
+    IntegerEconomy integers;
+    economy.money=1e30;
+    for (int upgrade=0; upgrade<TOTAL_UPGRADE; upgrade++) {
+        for (int count=0; count<UPGRADE_MAX_LEVEL[upgrade]; count++) {
+            integers.buy(ClickerUpgrade(upgrade));
+            if (!economy.buy(ClickerUpgrade(upgrade)) ||
+                economy.price[upgrade].toDouble()!=double(integers.price[upgrade]) ||
+                economy.gainPerHit.toDouble()!=double(integers.gainPerHit) ||
+                economy.passiveIncome.toDouble()!=double(integers.passiveIncome)) {
+                std::cout << "Upgrade " << upgrade << " level " << count+1 << " differs from the integer math" << std::endl;
+                return false;
+            }
+        }
+        if (economy.buy(ClickerUpgrade(upgrade))) {
+            std::cout << "Upgrade " << upgrade << " could be bought past its last level" << std::endl;
+            return false;
+        }
+    }
+
+    // An hour in one step against an hour of ticks
+    const int TICK_RATE=240, SECONDS=3600;
+    Economy ticked, jumped;
+    ticked.passiveIncome=jumped.passiveIncome=economy.passiveIncome;
+    for (int tick=0; tick<TICK_RATE*SECONDS; tick++) ticked.accrue(1.0/TICK_RATE);
+    jumped.accrue(SECONDS);
+    double error=std::fabs(((ticked.money-jumped.money)/jumped.money).toDouble());
+    if (error>1e-9) {
+        std::cout << "An hour of ticks and one step differ by " << error << std::endl;
+        return false;
+    }
+
+    // Far past what a double holds
+    char text[TEXT_BUFFER_SIZE];
+    Money huge=Money(1e300)*Money(1e300);
+    if (!(huge>Money(1e300)) || std::fabs(huge.log10()-600)>1e-6 || strcmp(formatMoney(text, huge), "1.00e600")!=0 ||
+        strcmp(formatMoney(text, Money(999999999999999.0)), "999999999999999")!=0 ||
+        strcmp(formatMoney(text, Money(1234567890123456789.0)), "1.23e18")!=0) {
+        std::cout << "Amounts past a double or a quadrillion are wrong, 1e300 squared is " << formatMoney(text, huge) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "TileTypes.h"
+
+// Idle tycoon money: a double mantissa with its own power of two exponent, so prices that keep tripling never wrap
+// Whole amounts stay exact below 2^53, past that it keeps the leading 53 bits like a double without ever overflowing
+class Money {
+public:
+    Money() : mantissa(0), exponent(0) {}
+    Money(double amount);
+
+    Money operator+(const Money &other) const;
+    Money operator-(const Money &other) const;
+    Money operator*(const Money &other) const;
+    Money operator/(const Money &other) const;
+    Money &operator+=(const Money &other) { return *this=*this+other; }
+    Money &operator-=(const Money &other) { return *this=*this-other; }
+    Money &operator*=(const Money &other) { return *this=*this*other; }
+
+    // -1, 0 or 1
+    int compare(const Money &other) const;
+    bool operator<(const Money &other) const { return compare(other)<0; }
+    bool operator>(const Money &other) const { return compare(other)>0; }
+    bool operator<=(const Money &other) const { return compare(other)<=0; }
+    bool operator>=(const Money &other) const { return compare(other)>=0; }
+    bool operator==(const Money &other) const { return compare(other)==0; }
+    bool operator!=(const Money &other) const { return compare(other)!=0; }
+
+    // Round down to a whole amount
+    Money floor() const;
+
+    // Infinity when it doesn't fit
+    double toDouble() const;
+
+    // Base 10 logarithm of the size (1000 is 3), for printing big amounts
+    double log10() const;
+
+private:
+    double mantissa; // 0, or 0.5 to 1 (either sign)
+    int exponent;    // Value is mantissa*2^exponent
+
+    static Money normalized(double mantissa, int exponent);
+};
+
+// Upgrade blocks of the Cookies level
+enum ClickerUpgrade {
+    UPGRADE_POSITION=0, // Lower the point block
+    UPGRADE_GAIN,       // More money per hit
+    UPGRADE_PASSIVE,    // More money per second
+    TOTAL_UPGRADE
+};
+
+const int UPGRADE_MAX_LEVEL[TOTAL_UPGRADE]={5, 25, 25};
+
+// Upgrade a tile buys, false if it isn't an upgrade block
+bool clickerUpgrade(TileType type, ClickerUpgrade &upgrade);
+
+// Everything the idle tycoon tracks for one attempt
+struct Economy {
+    Money money;
+    Money gainPerHit;
+    Money passiveIncome; // Per second
+    int level[TOTAL_UPGRADE];
+    Money price[TOTAL_UPGRADE];
+    Money increment[TOTAL_UPGRADE];
+    bool spikeReleased; // The spike starts moving once, when the money first passes a million
+
+    Economy() { reset(); }
+    void reset();
+
+    // Point block was hit
+    void click();
+
+    // Passive income over any stretch of time in one step, income only changes when something is bought
+    void accrue(double seconds);
+
+    // Pay for the next level of an upgrade, false if it's maxed or unaffordable
+    bool buy(ClickerUpgrade upgrade);
+};
+
+// Write prefix, whole amount and suffix into buffer (TEXT_BUFFER_SIZE chars) without allocating, returns buffer
+// Amounts past a quadrillion are written as 1.23e18
+const char *formatMoney(char *buffer, const Money &amount, const char *prefix="", const char *suffix="");
+
+// Self test: money against exact integer math and the closed form accrual against ticking, false if one differs
+bool testEconomy();
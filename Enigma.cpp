@@ -0,0 +1,273 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "Enigma.h"
+
+const std::vector<EnigmaCode> &allEnigmaCodes() {
+    static std::vector<EnigmaCode> codes=[] {
+        std::vector<EnigmaCode> result;
+        result.reserve(ENIGMA_CODES);
+        int digits[ENIGMA_DIGITS];
+        EnigmaCode code;
+        for (int n=0; n<10000; n++) {
+            for (int i=0, rest=n; i<ENIGMA_DIGITS; i++, rest/=10) digits[ENIGMA_DIGITS-1-i]=rest%10;
+            if (makeEnigmaCode(digits, code)) result.push_back(code);
+        }
+        return result;
+    }();
+    return codes;
+}
+
+bool makeEnigmaCode(const int digits[ENIGMA_DIGITS], EnigmaCode &code) {
+    code.digits=0;
+    code.mask=0;
+    for (int i=0; i<ENIGMA_DIGITS; i++) {
+        if (digits[i]<0 || digits[i]>9 || (code.mask>>digits[i])&1) return false;
+        code.digits|=uint16_t(digits[i]<<(4*i));
+        code.mask|=uint16_t(1<<digits[i]);
+    }
+    return true;
+}
+
+// Minimax over every code as the guess, candidates holds indices into allEnigmaCodes
+static EnigmaCode pickGuess(const std::vector<uint16_t> &candidates) {
+    const std::vector<EnigmaCode> &codes=allEnigmaCodes();
+    if (candidates.size()<=2) return codes[candidates[0]];
+
+    std::vector<bool> isCandidate(ENIGMA_CODES, false);
+    for (uint16_t index : candidates) isCandidate[index]=true;
+
+    int bestWorst=ENIGMA_CODES+1;
+    bool bestPossible=false;
+    EnigmaCode best=codes[candidates[0]];
+    int counts[ENIGMA_SCORES];
+    for (int g=0; g<ENIGMA_CODES; g++) {
+        std::fill(counts, counts+ENIGMA_SCORES, 0);
+        int worst=0;
+        for (uint16_t index : candidates) {
+            int count=++counts[scoreEnigma(codes[g], codes[index])];
+            if (count>worst) {
+                worst=count;
+                if (worst>bestWorst) break; // Can't beat the best one any more
+            }
+        }
+        if (worst<bestWorst || (worst==bestWorst && isCandidate[g] && !bestPossible)) {
+            bestWorst=worst;
+            bestPossible=isCandidate[g];
+            best=codes[g];
+        }
+    }
+    return best;
+}
+
+// Worst case of a guess: the most candidates that share one score
+static int worstSplit(EnigmaCode guess, const std::vector<uint16_t> &candidates) {
+    const std::vector<EnigmaCode> &codes=allEnigmaCodes();
+    int counts[ENIGMA_SCORES]={};
+    int worst=0;
+    for (uint16_t index : candidates) worst=std::max(worst, ++counts[scoreEnigma(guess, codes[index])]);
+    return worst;
+}
+
+// Opening guess, every one is as good as any other
+static const int OPENING[ENIGMA_DIGITS]={0, 1, 2, 3};
+
+// What pickGuess answers after the opening scored bulls*5+cows, testEnigma checks it still does
+// Rows of scores that can't happen (3 bulls 1 cow, more than 4 digits) are never used
+static const int SECOND_GUESS[ENIGMA_SCORES][ENIGMA_DIGITS]={
+    {4, 5, 6, 7}, {1, 4, 5, 6}, {1, 2, 0, 4}, {1, 0, 4, 5}, {0, 2, 3, 1},  // 0 bulls
+    {0, 1, 4, 5}, {0, 1, 4, 5}, {0, 1, 4, 5}, {0, 2, 3, 1}, {},            // 1 bull
+    {0, 2, 4, 5}, {0, 2, 4, 5}, {0, 1, 2, 4}, {}, {},                      // 2 bulls
+    {0, 1, 4, 5}, {}, {}, {}, {},                                          // 3 bulls
+    {0, 1, 2, 3}, {}, {}, {}, {}                                           // 4 bulls
+};
+
+// Scores don't change when digits are renamed, so renaming the opening into any first guess turns the answer to the
+// opening into an answer to that guess that is just as good
+static EnigmaCode renameDigits(const int digits[ENIGMA_DIGITS], EnigmaCode guess) {
+    int name[10];
+    for (int i=0; i<ENIGMA_DIGITS; i++) name[OPENING[i]]=enigmaDigit(guess, i);
+    for (int digit=0, next=ENIGMA_DIGITS; digit<10; digit++) {
+        if (!((guess.mask>>digit)&1)) name[next++]=digit;
+    }
+    int renamed[ENIGMA_DIGITS];
+    for (int i=0; i<ENIGMA_DIGITS; i++) renamed[i]=name[digits[i]];
+    EnigmaCode code;
+    makeEnigmaCode(renamed, code);
+    return code;
+}
+
+EnigmaSolver::EnigmaSolver() {
+    reset();
+}
+
+void EnigmaSolver::reset() {
+    possible.assign((ENIGMA_CODES+63)/64, ~0ULL);
+    possible.back()=(1ULL<<(ENIGMA_CODES%64))-1;
+    possibleCount=ENIGMA_CODES;
+    checkCount=0;
+    hintReady=false;
+}
+
+void EnigmaSolver::addCheck(EnigmaCode guess, int score) {
+    const std::vector<EnigmaCode> &codes=allEnigmaCodes();
+    if (checkCount++==0) {
+        firstGuess=guess;
+        firstScore=score;
+    }
+    int before=possibleCount;
+    possibleCount=0;
+    for (size_t word=0; word<possible.size(); word++) {
+        for (uint64_t bits=possible[word]; bits!=0; bits&=bits-1) {
+            size_t index=word*64+__builtin_ctzll(bits);
+            if (scoreEnigma(guess, codes[index])!=score) possible[word]&=~(1ULL<<(index%64));
+        }
+        possibleCount+=__builtin_popcountll(possible[word]);
+    }
+    if (possibleCount!=before) hintReady=false; // Same codes left, same answer
+}
+
+int EnigmaSolver::remaining() const {
+    return possibleCount;
+}
+
+EnigmaCode EnigmaSolver::bestGuess() {
+    if (hintReady) return hint;
+    if (possibleCount==ENIGMA_CODES) makeEnigmaCode(OPENING, hint);
+    else if (possibleCount==0) hint=allEnigmaCodes()[0];
+    else if (checkCount==1) hint=renameDigits(SECOND_GUESS[firstScore], firstGuess);
+    else {
+        std::vector<uint16_t> candidates;
+        candidates.reserve(possibleCount);
+        for (size_t word=0; word<possible.size(); word++) {
+            for (uint64_t bits=possible[word]; bits!=0; bits&=bits-1) candidates.push_back(word*64+__builtin_ctzll(bits));
+        }
+        hint=pickGuess(candidates);
+    }
+    hintReady=true;
+    return hint;
+}
+
+EnigmaCode generateEnigmaCode(std::mt19937 &random) {
+    std::vector<int> digits={0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::shuffle(digits.begin(), digits.end(), random);
+    EnigmaCode code;
+    makeEnigmaCode(digits.data(), code);
+    return code;
+}
+
+// Play the solver's strategy against every password at once: guess, split the candidates by score, recurse
+// guesses[index] gets the number of checks that password needed
+static void solveAll(const std::vector<uint16_t> &candidates, EnigmaCode guess, int depth, std::vector<int> &guesses) {
+    const std::vector<EnigmaCode> &codes=allEnigmaCodes();
+    std::vector<uint16_t> split[ENIGMA_SCORES];
+    for (uint16_t index : candidates) split[scoreEnigma(guess, codes[index])].push_back(index);
+    for (uint16_t index : split[ENIGMA_SOLVED]) guesses[index]=depth;
+    for (int score=0; score<ENIGMA_SCORES; score++) {
+        if (score==ENIGMA_SOLVED || split[score].empty()) continue;
+        solveAll(split[score], pickGuess(split[score]), depth+1, guesses);
+    }
+}
+
+bool testEnigma() {
+    const std::vector<EnigmaCode> &codes=allEnigmaCodes();
+    if (codes.size()!=size_t(ENIGMA_CODES)) {
+        std::cout << codes.size() << " passwords instead of " << ENIGMA_CODES << std::endl;
+        return false;
+    }
+
+    // Kernel against the slow count, every pair
+    for (int a=0; a<ENIGMA_CODES; a++) {
+        for (int b=0; b<ENIGMA_CODES; b++) {
+            int bulls=0, cows=0;
+            for (int i=0; i<ENIGMA_DIGITS; i++) {
+                for (int j=0; j<ENIGMA_DIGITS; j++) {
+                    if (enigmaDigit(codes[a], i)==enigmaDigit(codes[b], j)) (i==j ? bulls : cows)++;
+                }
+            }
+            if (scoreEnigma(codes[a], codes[b])!=bulls*5+cows) {
+                std::cout << "Score kernel is wrong for passwords " << a << " and " << b << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Table of second guesses against the search it stands in for, after the opening and after other first guesses
+    EnigmaCode opening;
+    makeEnigmaCode(OPENING, opening);
+    for (int test=0; test<ENIGMA_SCORES+20; test++) {
+        EnigmaCode first=opening;
+        int score=test;
+        if (test>=ENIGMA_SCORES) {
+            std::mt19937 random(test);
+            first=codes[random()%ENIGMA_CODES];
+            score=scoreEnigma(first, generateEnigmaCode(random));
+        }
+        std::vector<uint16_t> candidates;
+        for (int i=0; i<ENIGMA_CODES; i++) {
+            if (scoreEnigma(first, codes[i])==score) candidates.push_back(i);
+        }
+        if (candidates.empty()) continue;
+        EnigmaSolver firstCheck;
+        firstCheck.addCheck(first, score);
+        EnigmaCode table=firstCheck.bestGuess(), searched=pickGuess(candidates);
+        bool tablePossible=scoreEnigma(first, table)==score, searchedPossible=scoreEnigma(first, searched)==score;
+        if ((test<ENIGMA_SCORES && table.digits!=searched.digits) || tablePossible!=searchedPossible ||
+            worstSplit(table, candidates)!=worstSplit(searched, candidates)) {
+            std::cout << "Second guess table is wrong for a first check scoring " << score << std::endl;
+            return false;
+        }
+    }
+
+    // Solver against every password
+    std::vector<uint16_t> all(ENIGMA_CODES);
+    for (int i=0; i<ENIGMA_CODES; i++) all[i]=i;
+    std::vector<int> guesses(ENIGMA_CODES, 0);
+    EnigmaSolver solver;
+    solveAll(all, solver.bestGuess(), 1, guesses);
+    int most=0;
+    for (int i=0; i<ENIGMA_CODES; i++) {
+        if (guesses[i]==0) {
+            std::cout << "Solver never found password " << i << std::endl;
+            return false;
+        }
+        most=std::max(most, guesses[i]);
+    }
+    if (most>ENIGMA_MAX_CHECKS) {
+        std::cout << "Solver needs " << most << " checks for some password, more than " << ENIGMA_MAX_CHECKS << std::endl;
+        return false;
+    }
+
+    // Level passwords of the first seeds have to be valid codes
+    std::vector<int> indexOf(1<<16, -1);
+    for (int i=0; i<ENIGMA_CODES; i++) indexOf[codes[i].digits]=i;
+    for (unsigned int seed=0; seed<100000; seed++) {
+        std::mt19937 random(seed);
+        EnigmaCode secret=generateEnigmaCode(random);
+        int index=indexOf[secret.digits];
+        if (index<0 || codes[index].mask!=secret.mask) {
+            std::cout << "Seed " << seed << " makes an invalid password" << std::endl;
+            return false;
+        }
+    }
+
+    // A few of them played through the incremental solver, like a player taking every hint
+    for (unsigned int seed=0; seed<100; seed++) {
+        std::mt19937 random(seed);
+        EnigmaCode secret=generateEnigmaCode(random);
+        solver.reset();
+        int checks=0, score=0;
+        do {
+            EnigmaCode guess=solver.bestGuess();
+            score=scoreEnigma(guess, secret);
+            solver.addCheck(guess, score);
+            checks++;
+        } while (score!=ENIGMA_SOLVED && checks<=most);
+        if (score!=ENIGMA_SOLVED || solver.remaining()!=1 || checks!=guesses[indexOf[secret.digits]]) {
+            std::cout << "Hints for seed " << seed << " don't solve it like the full solver" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
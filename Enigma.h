@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <random>
+
+// Enigma password: 4 different digits, a check scores bulls (right digit, right place) and cows (right digit, wrong place)
+// A code is packed one digit per nibble with the first digit lowest, plus a mask of the digits it uses
+
+const int ENIGMA_DIGITS=4;
+const int ENIGMA_CODES=5040; // 10*9*8*7
+
+struct EnigmaCode {
+    uint16_t digits;
+    uint16_t mask;
+};
+
+// Scores are bulls*5+cows
+const int ENIGMA_SCORES=25;
+const int ENIGMA_SOLVED=ENIGMA_DIGITS*5;
+
+// Checks the solver may need for the hardest password, minimax over every code never needs more
+const int ENIGMA_MAX_CHECKS=7;
+
+// Every code with 4 different digits, in increasing order
+const std::vector<EnigmaCode> &allEnigmaCodes();
+
+// Pack digits into a code, false if one repeats or isn't a digit
+bool makeEnigmaCode(const int digits[ENIGMA_DIGITS], EnigmaCode &code);
+
+inline int enigmaDigit(EnigmaCode code, int position) {
+    return (code.digits>>(4*position))&0xF;
+}
+
+// Both codes need different digits: bulls are the nibbles that match, cows the shared digits that aren't bulls
+inline int scoreEnigma(EnigmaCode guess, EnigmaCode secret) {
+    unsigned diff=guess.digits^secret.digits;
+    unsigned differs=(diff|diff>>1|diff>>2|diff>>3)&0x1111;
+    int bulls=ENIGMA_DIGITS-__builtin_popcount(differs);
+    int shared=__builtin_popcount(guess.mask&secret.mask);
+    return bulls*5+shared-bulls;
+}
+
+// Passwords still possible after the checks so far, one bit per code of allEnigmaCodes
+class EnigmaSolver {
+public:
+    EnigmaSolver();
+
+    // Every code is possible again
+    void reset();
+
+    // Drop every code that would have scored differently against this guess
+    void addCheck(EnigmaCode guess, int score);
+
+    int remaining() const;
+
+    // Guess that leaves the fewest possible codes in the worst case (possible codes win ties), cached until a check
+    // rules something out
+    // The answer to a first check comes from a table, later ones search every code (a few ms), so ask right after the
+    // check rather than while drawing
+    EnigmaCode bestGuess();
+
+private:
+    std::vector<uint64_t> possible;
+    int possibleCount;
+    int checkCount;
+    EnigmaCode firstGuess;
+    int firstScore;
+    bool hintReady;
+    EnigmaCode hint;
+};
+
+// Password from the level's random numbers (shuffled digits, first four)
+EnigmaCode generateEnigmaCode(std::mt19937 &random);
+
+// Self test: let the solver crack every password and the passwords of the first seeds, false if one fails
+bool testEnigma();
@@ -24,6 +24,7 @@ enum GameStatus {
     CREDITS,
     WIN,
     RESTART,
+    TRANSITION, // Fading out after a death, the next level starts when it's done
     STATUS_COUNT,
     TEST
 };
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <SDL.h>
+#include "FramePacer.h"
+
+PacingMode pacingMode=PACING_VSYNC;
+int frameCap=0;
+
+static double frameLength=0;       // Seconds per frame when capped
+static Uint64 nextFrame=0;         // Counter value the next capped frame is due at
+static Uint64 lastPresent=0;
+
+// Frame time statistics (Welford), in seconds
+static long long frameCount=0;
+static double frameMean=0;
+static double frameM2=0;
+static double frameMax=0;
+static long long lateFrames=0;     // Took more than one and a half frames
+
+static const char *pacingName[]={"vsync", "cap", "unlimited"};
+
+bool parsePacingMode(const std::string &name, PacingMode &mode) {
+    for (int i=0; i<3; i++) {
+        if (name==pacingName[i]) {
+            mode=PacingMode(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Refresh rate of the display the window is on, 0 if unknown
+static int refreshRate(SDL_Window *window) {
+    SDL_DisplayMode displayMode;
+    int display=SDL_GetWindowDisplayIndex(window);
+    if (display<0 || SDL_GetCurrentDisplayMode(display, &displayMode)!=0) return 0;
+    return displayMode.refresh_rate;
+}
+
+void setPacing(SDL_Renderer *renderer, SDL_Window *window, PacingMode mode) {
+    if (SDL_RenderSetVSync(renderer, mode==PACING_VSYNC)!=0 && mode==PACING_VSYNC) {
+        std::cout << "Vsync not available, capping the frame rate instead. " << SDL_GetError() << std::endl;
+        mode=PACING_CAP;
+    }
+    pacingMode=mode;
+
+    int cap=frameCap;
+    if (cap<=0) cap=refreshRate(window);
+    if (cap<=0) cap=DEFAULT_FRAME_CAP;
+    frameLength=1.0/cap;
+    nextFrame=0;
+    lastPresent=0;
+}
+
+static void recordFrame(double frameTime) {
+    frameCount++;
+    double delta=frameTime-frameMean;
+    frameMean+=delta/frameCount;
+    frameM2+=delta*(frameTime-frameMean);
+    if (frameTime>frameMax) frameMax=frameTime;
+    if (pacingMode!=PACING_UNLIMITED && frameTime>frameLength*1.5) lateFrames++;
+}
+
+void paceFrame() {
+    Uint64 frequency=SDL_GetPerformanceFrequency();
+    if (pacingMode==PACING_CAP) {
+        Uint64 now=SDL_GetPerformanceCounter();
+        Uint64 length=Uint64(frameLength*frequency);
+        if (nextFrame==0 || now>nextFrame+length) nextFrame=now; // Too far behind to catch up, start over
+        nextFrame+=length;
+
+        // Sleep most of the way, the OS may wake us late so the last bit is spun
+        if (now<nextFrame) {
+            double remaining=double(nextFrame-now)/frequency;
+            if (remaining>PACING_SPIN_TIME) SDL_Delay(Uint32((remaining-PACING_SPIN_TIME)*1000));
+            while (SDL_GetPerformanceCounter()<nextFrame) {}
+        }
+    }
+
+    Uint64 now=SDL_GetPerformanceCounter();
+    if (lastPresent!=0) recordFrame(double(now-lastPresent)/frequency);
+    lastPresent=now;
+}
+
+void reportPacing() {
+    if (frameCount==0) return;
+    double jitter=(frameCount>1 ? std::sqrt(frameM2/(frameCount-1)) : 0);
+    std::cout << "Frame pacing (" << pacingName[pacingMode] << "): " << frameCount << " frames, "
+              << 1/frameMean << " fps, mean " << frameMean*1000 << " ms, jitter " << jitter*1000 << " ms, worst "
+              << frameMax*1000 << " ms";
+    if (pacingMode!=PACING_UNLIMITED) std::cout << ", " << lateFrames << " late";
+    std::cout << std::endl;
+}
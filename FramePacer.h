@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <SDL.h>
+
+// How the main loop waits between frames
+enum PacingMode {
+    PACING_VSYNC,       // Present waits for the display
+    PACING_CAP,         // Sleep, then spin, until the next frame is due
+    PACING_UNLIMITED    // No waiting at all, for benchmarking
+};
+
+// Frame cap when neither --fps nor the display refresh rate is known
+const int DEFAULT_FRAME_CAP=60;
+
+// The OS sleep can overshoot by about this much, the rest of the wait is spun
+const double PACING_SPIN_TIME=0.002;
+
+// Chosen pacing (--pacing vsync|cap|unlimited) and the cap in frames per second (--fps, 0 means the refresh rate)
+extern PacingMode pacingMode;
+extern int frameCap;
+
+// Parse a --pacing value, false if it isn't one
+bool parsePacingMode(const std::string &name, PacingMode &mode);
+
+// Switch pacing, vsync falls back to a cap at the refresh rate when the renderer can't do it
+void setPacing(SDL_Renderer *renderer, SDL_Window *window, PacingMode mode);
+
+// Wait until the next frame is due, call right after presenting
+void paceFrame();
+
+// Print the achieved frame rate and frame time jitter
+void reportPacing();
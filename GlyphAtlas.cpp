@@ -0,0 +1,137 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Texture.h"
+#include "GlyphAtlas.h"
+using namespace std;
+
+GlyphAtlas::GlyphAtlas() : batch(&texture) {
+    free();
+}
+
+bool GlyphAtlas::load(TTF_Font *font, SDL_Color color) {
+    free();
+    height=TTF_FontHeight(font);
+    color.a=255; // Transparency comes from the glyph's colorkey, fading from render()
+
+    // Rasterize every glyph and find its place in the atlas
+    SDL_Surface *glyph[GLYPH_COUNT]={};
+    int x=0, y=0, rowHeight=0;
+    bool success=true;
+    for (int i=0; i<GLYPH_COUNT && success; i++) {
+        Uint16 ch=FIRST_GLYPH+i;
+        glyph[i]=TTF_RenderGlyph_Solid(font, ch, color);
+        int minX, maxX, minY, maxY;
+        if (glyph[i]==nullptr || TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance[i])!=0) {
+            cout << "Unable to render glyph. " << TTF_GetError() << endl;
+            success=false;
+            break;
+        }
+        if (x+glyph[i]->w>GLYPH_ATLAS_WIDTH) {
+            x=0;
+            y+=rowHeight+1;
+            rowHeight=0;
+        }
+        glyphClip[i]={x, y, glyph[i]->w, glyph[i]->h};
+        x+=glyph[i]->w+1; // Keep a gap so filtering never picks up the next glyph
+        rowHeight=std::max(rowHeight, glyph[i]->h);
+    }
+
+    // Copy them into one surface, then one texture
+    if (success) {
+        SDL_Surface *atlas=SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y+rowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+        if (atlas==nullptr) {
+            cout << "Unable to create glyph atlas. " << SDL_GetError() << endl;
+            success=false;
+        }
+        else {
+            for (int i=0; i<GLYPH_COUNT; i++) {
+                SDL_Rect destination=glyphClip[i]; // Blitting writes the clipped rectangle back
+                SDL_BlitSurface(glyph[i], nullptr, atlas, &destination);
+            }
+            success=texture.loadFromSurface(atlas);
+            SDL_FreeSurface(atlas);
+        }
+    }
+    for (int i=0; i<GLYPH_COUNT; i++) {
+        if (glyph[i]!=nullptr) SDL_FreeSurface(glyph[i]);
+    }
+
+    if (success) {
+        for (int a=0; a<GLYPH_COUNT; a++) {
+            for (int b=0; b<GLYPH_COUNT; b++) kerning[a][b]=TTF_GetFontKerningSizeGlyphs(font, FIRST_GLYPH+a, FIRST_GLYPH+b);
+        }
+    }
+    return success;
+}
+
+void GlyphAtlas::free() {
+    texture.free();
+    memset(glyphClip, 0, sizeof(glyphClip));
+    memset(advance, 0, sizeof(advance));
+    memset(kerning, 0, sizeof(kerning));
+    height=0;
+}
+
+// Index of a character in the atlas, -1 when it has no glyph
+static int glyphIndex(char ch) {
+    return (ch>=FIRST_GLYPH && ch<=LAST_GLYPH) ? ch-FIRST_GLYPH : -1;
+}
+
+float GlyphAtlas::getWidth(const char *text) const {
+    int width=0, previous=-1;
+    for (const char *ch=text; *ch; ch++) {
+        int index=glyphIndex(*ch);
+        if (index<0) continue;
+        if (previous>=0) width+=kerning[previous][index];
+        width+=advance[index];
+        previous=index;
+    }
+    return width;
+}
+
+float GlyphAtlas::getHeight() const {
+    return height;
+}
+
+void GlyphAtlas::render(const char *text, float x, float y, Uint8 alpha) {
+    float penX=x;
+    int previous=-1;
+    for (const char *ch=text; *ch; ch++) {
+        int index=glyphIndex(*ch);
+        if (index<0) continue;
+        if (previous>=0) penX+=kerning[previous][index];
+        const SDL_Rect &clip=glyphClip[index];
+        if (clip.w>0) batch.add({penX, y, float(clip.w), float(clip.h)}, clip, 0.0, SDL_FLIP_NONE, {255, 255, 255, alpha});
+        penX+=advance[index];
+        previous=index;
+    }
+}
+void GlyphAtlas::render(const std::string &text, float x, float y, Uint8 alpha) {
+    render(text.c_str(), x, y, alpha);
+}
+
+void GlyphAtlas::flush() {
+    batch.flush();
+}
+
+const char *formatNumber(char *buffer, long long value, const char *prefix, const char *suffix) {
+    char digits[24];
+    int count=0;
+    unsigned long long magnitude=(value<0 ? 0ull-(unsigned long long)value : (unsigned long long)value);
+    do {
+        digits[count++]='0'+magnitude%10;
+        magnitude/=10;
+    } while (magnitude>0);
+
+    char *out=buffer, *end=buffer+TEXT_BUFFER_SIZE-1;
+    for (const char *ch=prefix; *ch && out<end; ch++) *out++=*ch;
+    if (value<0 && out<end) *out++='-';
+    while (count>0 && out<end) *out++=digits[--count];
+    for (const char *ch=suffix; *ch && out<end; ch++) *out++=*ch;
+    *out='\0';
+    return buffer;
+}
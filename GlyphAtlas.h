@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Texture.h"
+#include "SpriteBatch.h"
+
+// Printable ASCII, anything else is skipped
+const char FIRST_GLYPH=' ';
+const char LAST_GLYPH='~';
+const int GLYPH_COUNT=LAST_GLYPH-FIRST_GLYPH+1;
+
+// Atlas texture width, glyphs are packed in rows
+const int GLYPH_ATLAS_WIDTH=1024;
+
+// Big enough for any number with a short prefix and suffix
+const int TEXT_BUFFER_SIZE=64;
+
+// Every glyph of one font rasterized once into a texture, strings are drawn as quads from it
+// Drawing text allocates nothing, quads are collected until flush()
+class GlyphAtlas {
+public:
+    GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&)=delete;
+    GlyphAtlas &operator=(const GlyphAtlas&)=delete;
+
+    // Rasterize the font
+    bool load(TTF_Font *font, SDL_Color color);
+    void free();
+
+    // Size of a string as TTF_RenderText would make it
+    float getWidth(const char *text) const;
+    float getHeight() const;
+
+    // Queue a string with its top left corner at x, y
+    void render(const char *text, float x, float y, Uint8 alpha=255);
+    void render(const std::string &text, float x, float y, Uint8 alpha=255);
+
+    // Draw the queued strings
+    void flush();
+
+private:
+    LTexture texture;
+    SpriteBatch batch;
+    SDL_Rect glyphClip[GLYPH_COUNT];
+    int advance[GLYPH_COUNT];
+    int kerning[GLYPH_COUNT][GLYPH_COUNT];
+    int height;
+};
+
+// Write prefix, value and suffix into buffer (TEXT_BUFFER_SIZE chars) without allocating, returns buffer
+const char *formatNumber(char *buffer, long long value, const char *prefix="", const char *suffix="");
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <SDL.h>
+#include "Player.h"
+#include "LoadLevel.h"
+#include "Simulation.h"
+#include "Timestep.h"
+#include "Enums.h"
+#include "Replay.h"
+#include "Headless.h"
+
+uint8_t scriptedKeys(long long tick, unsigned int &state, uint8_t keys) {
+    if (tick%SCRIPTED_INPUT_PERIOD!=0) return keys;
+    state=state*1103515245u+12345u;
+    return (state>>16)&(REPLAY_LEFT|REPLAY_RIGHT|REPLAY_JUMP);
+}
+
+int runHeadless(int argc, char *argv[]) {
+    long long ticks=(argc>=3 ? atoll(argv[2]) : 10*DEFAULT_TICK_RATE);
+    unsigned int seed=(argc>=4 ? strtoul(argv[3], nullptr, 10) : 1);
+    if (ticks<=0) {
+        std::cout << "Tick count must be positive." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    for (int i=4; i<argc; i++) names.push_back(argv[i]);
+    if (names.empty()) names.assign(levelName+1, levelName+ALL_LEVELS); // Skip The Hub, it has no file
+
+    int failed=0;
+    for (const auto &name : names) {
+        if (!startLevel(name, seed)) {
+            std::cout << name << ": failed to load" << std::endl;
+            failed++;
+            continue;
+        }
+
+        unsigned int inputState=seed;
+        uint8_t keys=0;
+        int deaths=0, exits=0;
+        long long tick=0;
+        Uint64 start=SDL_GetPerformanceCounter();
+        while (tick<ticks) {
+            // One attempt, start over on the same level when it ends instead of moving on
+            Player cube;
+            GameStatus currentStatus=PLAYING;
+            bool dead=false;
+            if (tick>0) startLevel(name, seed);
+            for (; tick<ticks && !dead && currentStatus==PLAYING; tick++) {
+                keys=scriptedKeys(tick, inputState, keys);
+                applyInputKeys(cube, keys);
+                simulateTick(cube, currentStatus, dead, tickLength());
+            }
+            if (dead) deaths++;
+            else if (currentStatus!=PLAYING) exits++;
+        }
+        double seconds=double(SDL_GetPerformanceCounter()-start)/SDL_GetPerformanceFrequency();
+
+        std::cout << std::left << std::setw(18) << name << std::right
+                  << " ticks " << ticks << "  deaths " << deaths << "  exits " << exits
+                  << "  " << std::fixed << std::setprecision(0) << (seconds>0 ? ticks/seconds : 0.0) << " ticks/s" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return failed==0 ? 0 : 1;
+}
+
+int runHeadlessReplay(const std::string &path) {
+    Replay replay;
+    if (!loadReplay(path, replay) || !applyReplaySettings(replay)) return 1;
+
+    int mismatches=0;
+    for (size_t i=0; i<replay.attempts.size(); i++) {
+        const ReplayAttempt &attempt=replay.attempts[i];
+        if (!startLevel(attempt.levelName, attempt.seed)) {
+            std::cout << attempt.levelName << ": failed to load" << std::endl;
+            mismatches++;
+            continue;
+        }
+
+        Player cube;
+        GameStatus currentStatus=PLAYING;
+        bool dead=false;
+        ReplayReader reader(attempt);
+        uint8_t keys;
+        uint32_t ticks=0;
+        Uint64 start=SDL_GetPerformanceCounter();
+        while (!dead && currentStatus==PLAYING && reader.next(keys)) {
+            applyInputKeys(cube, keys);
+            simulateTick(cube, currentStatus, dead, tickLength());
+            ticks++;
+        }
+        double seconds=double(SDL_GetPerformanceCounter()-start)/SDL_GetPerformanceFrequency();
+
+        bool match=ticks==attempt.tickCount && hashLevelState(cube)==attempt.endHash;
+        if (!match) mismatches++;
+        std::cout << "Attempt " << i+1 << " " << std::left << std::setw(18) << attempt.levelName << std::right
+                  << " ticks " << ticks << "/" << attempt.tickCount << "  " << (match ? "match" : "MISMATCH")
+                  << "  " << std::fixed << std::setprecision(0) << (seconds>0 ? ticks/seconds : 0.0) << " ticks/s" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return mismatches==0 ? 0 : 1;
+}
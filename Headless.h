@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Ticks between input changes of the scripted input
+const int SCRIPTED_INPUT_PERIOD=24;
+
+// Scripted input shared by headless runs and the benchmark: a new random key mask (Replay.h bits) every
+// SCRIPTED_INPUT_PERIOD ticks, the same state gives the same keys
+uint8_t scriptedKeys(long long tick, unsigned int &state, uint8_t keys);
+
+// Run levels with no window, renderer or audio device, as fast as the CPU allows
+// "Die to Win" --headless [ticks] [seed] [level name...]   (every level when no name is given)
+// Input is a seeded pattern of left/right/jump changes, prints one line per level
+int runHeadless(int argc, char *argv[]);
+
+// Play a replay file at full speed with no window and check every attempt ends like it was recorded
+// "Die to Win" --replay-fast file
+int runHeadlessReplay(const std::string &path);
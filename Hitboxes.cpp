@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+#include "Hitboxes.h"
+
+// SSE2 is part of x86-64, AVX2 is picked at runtime with a target attribute (gcc/clang)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2__))
+#define HITBOX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+HitboxArrays spikeHitboxes;
+HitboxArrays jumpOrbHitboxes;
+HitboxArrays jumpPadHitboxes;
+
+// All kernels compare in double, same as checkCollision (player position is double, edges are float)
+
+// Plain version, also handles what is left after the vector loops
+static uint64_t overlapScalar(const HitboxArrays &boxes, size_t begin, size_t end,
+                              double playerLeft, double playerTop, double playerRight, double playerBottom, uint64_t *words) {
+    uint64_t any=0;
+    for (size_t i=begin; i<end; i++) {
+        uint64_t hit=playerRight>=boxes.left[i] && playerLeft<=boxes.right[i] &&
+                     playerBottom>=boxes.top[i] && playerTop<=boxes.bottom[i];
+        words[i/64]|=hit<<(i%64);
+        any|=hit;
+    }
+    return any;
+}
+
+#ifdef HITBOX_SIMD_X86
+// 4 boxes per step, loaded as floats and compared as 2 pairs of doubles
+static size_t overlapSSE2(const HitboxArrays &boxes, size_t count,
+                          double playerLeft, double playerTop, double playerRight, double playerBottom, uint64_t *words) {
+    const __m128d pLeft=_mm_set1_pd(playerLeft), pTop=_mm_set1_pd(playerTop);
+    const __m128d pRight=_mm_set1_pd(playerRight), pBottom=_mm_set1_pd(playerBottom);
+    size_t i=0;
+    for (; i+4<=count; i+=4) {
+        __m128 left=_mm_loadu_ps(&boxes.left[i]), top=_mm_loadu_ps(&boxes.top[i]);
+        __m128 right=_mm_loadu_ps(&boxes.right[i]), bottom=_mm_loadu_ps(&boxes.bottom[i]);
+        for (int half=0; half<2; half++) {
+            __m128d l=_mm_cvtps_pd(left), t=_mm_cvtps_pd(top), r=_mm_cvtps_pd(right), b=_mm_cvtps_pd(bottom);
+            __m128d hit=_mm_and_pd(_mm_and_pd(_mm_cmpge_pd(pRight, l), _mm_cmple_pd(pLeft, r)),
+                                   _mm_and_pd(_mm_cmpge_pd(pBottom, t), _mm_cmple_pd(pTop, b)));
+            size_t j=i+half*2;
+            words[j/64]|=uint64_t(_mm_movemask_pd(hit))<<(j%64);
+            left=_mm_movehl_ps(left, left); top=_mm_movehl_ps(top, top);
+            right=_mm_movehl_ps(right, right); bottom=_mm_movehl_ps(bottom, bottom);
+        }
+    }
+    return i;
+}
+
+// 4 boxes per step, only used when the CPU has it
+__attribute__((target("avx2")))
+static size_t overlapAVX2(const HitboxArrays &boxes, size_t count,
+                          double playerLeft, double playerTop, double playerRight, double playerBottom, uint64_t *words) {
+    const __m256d pLeft=_mm256_set1_pd(playerLeft), pTop=_mm256_set1_pd(playerTop);
+    const __m256d pRight=_mm256_set1_pd(playerRight), pBottom=_mm256_set1_pd(playerBottom);
+    size_t i=0;
+    for (; i+4<=count; i+=4) {
+        __m256d l=_mm256_cvtps_pd(_mm_loadu_ps(&boxes.left[i])), t=_mm256_cvtps_pd(_mm_loadu_ps(&boxes.top[i]));
+        __m256d r=_mm256_cvtps_pd(_mm_loadu_ps(&boxes.right[i])), b=_mm256_cvtps_pd(_mm_loadu_ps(&boxes.bottom[i]));
+        __m256d hit=_mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(pRight, l, _CMP_GE_OQ), _mm256_cmp_pd(pLeft, r, _CMP_LE_OQ)),
+                                  _mm256_and_pd(_mm256_cmp_pd(pBottom, t, _CMP_GE_OQ), _mm256_cmp_pd(pTop, b, _CMP_LE_OQ)));
+        words[i/64]|=uint64_t(_mm256_movemask_pd(hit))<<(i%64);
+    }
+    return i;
+}
+#endif
+
+bool overlapHitboxes(const HitboxArrays &boxes, double playerX, double playerY, int PLAYER_WIDTH, int PLAYER_HEIGHT,
+                     std::vector<uint64_t> &mask) {
+    size_t count=boxes.left.size();
+    mask.assign((count+63)/64, 0);
+    if (count==0) return false;
+
+    double playerLeft=playerX, playerTop=playerY;
+    double playerRight=playerX+PLAYER_WIDTH, playerBottom=playerY+PLAYER_HEIGHT;
+    uint64_t *words=mask.data();
+
+    size_t done=0;
+#ifdef HITBOX_SIMD_X86
+    static const bool hasAVX2=SDL_HasAVX2();
+    if (hasAVX2) done=overlapAVX2(boxes, count, playerLeft, playerTop, playerRight, playerBottom, words);
+    else done=overlapSSE2(boxes, count, playerLeft, playerTop, playerRight, playerBottom, words);
+#endif
+    overlapScalar(boxes, done, count, playerLeft, playerTop, playerRight, playerBottom, words);
+
+    for (uint64_t word : mask) {
+        if (word) return true;
+    }
+    return false;
+}
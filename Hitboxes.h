@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+
+// Packed copy of the hitboxes of one object kind (structure of arrays), so the player can be tested
+// against every object of that kind at once with SIMD instead of one object at a time.
+// Edges are stored the way checkCollision computes them (right=x+w in float), results are identical.
+struct HitboxArrays {
+    std::vector<float> left, top, right, bottom;
+
+    // Which vector and which level load the arrays were copied from
+    const void *source=nullptr;
+    unsigned int revision=0;
+};
+
+// Mirrors of the level objects that are tested against the player every frame
+extern HitboxArrays spikeHitboxes;
+extern HitboxArrays jumpOrbHitboxes;
+extern HitboxArrays jumpPadHitboxes;
+
+// Update one entry after its object moved
+inline void setHitbox(HitboxArrays &boxes, size_t i, const SDL_FRect &hitbox) {
+    boxes.left[i]=hitbox.x;
+    boxes.top[i]=hitbox.y;
+    boxes.right[i]=hitbox.x+hitbox.w;
+    boxes.bottom[i]=hitbox.y+hitbox.h;
+}
+
+// Copy every hitbox again if a level was loaded or objects were added since the last copy
+template <typename T>
+void syncHitboxes(HitboxArrays &boxes, const std::vector<T> &objects) {
+    if (boxes.source==&objects && boxes.revision==levelRevision && boxes.left.size()==objects.size()) return;
+    boxes.source=&objects;
+    boxes.revision=levelRevision;
+    boxes.left.resize(objects.size());
+    boxes.top.resize(objects.size());
+    boxes.right.resize(objects.size());
+    boxes.bottom.resize(objects.size());
+    for (size_t i=0; i<objects.size(); i++) setHitbox(boxes, i, objects[i].getHitbox());
+}
+
+// Test the player against every hitbox (edges touching count, like checkCollision)
+// Bit i of the mask is set when object i is hit, returns true if anything was hit
+bool overlapHitboxes(const HitboxArrays &boxes, double playerX, double playerY, int PLAYER_WIDTH, int PLAYER_HEIGHT,
+                     std::vector<uint64_t> &mask);
+
+// Check a bit of a hit mask
+inline bool isHit(const std::vector<uint64_t> &mask, size_t i) {
+    return (mask[i/64]>>(i%64))&1;
+}
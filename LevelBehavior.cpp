@@ -0,0 +1,228 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <SDL.h>
+#include "Player.h"
+#include "LevelObjs.h"
+#include "Audio.h"
+#include "LevelBehavior.h"
+
+extern const int SCREEN_WIDTH;
+extern const int SCREEN_HEIGHT;
+
+// One FNV-1a step over a whole value, for stateHash
+static const uint64_t STATE_HASH_START=14695981039346656037ull;
+static uint64_t mixState(uint64_t hash, uint64_t value) {
+    return (hash^value)*1099511628211ull;
+}
+
+// Clock values in whole milliseconds, finer than any tick so waiting always leads somewhere new
+static uint64_t milliseconds(double seconds) {
+    return uint64_t(seconds*1000+0.5);
+}
+
+// Idle tycoon
+class CookiesBehavior : public LevelBehavior {
+public:
+    void update(Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                std::vector<Spike> &spikes, double deltaTime, bool &dead) override {
+        cube.economy.accrue(deltaTime);
+        if (!cube.economy.spikeReleased && cube.economy.money>1000000) {
+            cube.economy.spikeReleased=true;
+            for (auto &spike : spikes) {
+                startMoving(spikes, spike, SCREEN_WIDTH-TILE_SIZE*8-TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f,
+                            SCREEN_HEIGHT-TILE_SIZE*3-TILE_SIZE/2.0f+TILE_SIZE*3/10.0f);
+            }
+        }
+    }
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactClicker(cube.economy, blocks, spikes, deltaTime);
+    }
+    void catchUp(Player &cube, double seconds) override {
+        cube.economy.accrue(seconds);
+    }
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        uint64_t hash=mixState(STATE_HASH_START, uint64_t(std::min(cube.economy.money.floor().toDouble(), 1e18)));
+        for (int upgrade=0; upgrade<TOTAL_UPGRADE; upgrade++) hash=mixState(hash, cube.economy.level[upgrade]);
+        return mixState(hash, cube.economy.spikeReleased);
+    }
+};
+
+// Password puzzle
+class EnigmaBehavior : public LevelBehavior {
+public:
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactEnigma(blocks, spikes);
+    }
+    // Digits dialed in so far
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        uint64_t hash=STATE_HASH_START;
+        for (const auto &block : blocks) {
+            if (block.getType()==TILE_1BI) hash=mixState(hash, block.counter);
+        }
+        return hash;
+    }
+};
+
+// Reset button for the pushable blocks
+class MoveToDieBehavior : public LevelBehavior {
+public:
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactMoveToDie(blocks, pushableBlocks, cube.timeStopped, cube.timeStopTimer);
+    }
+};
+
+// Time stop, on top of Move to Die's reset button
+class IllusionWorldBehavior : public MoveToDieBehavior {
+public:
+    void update(Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                std::vector<Spike> &spikes, double deltaTime, bool &dead) override {
+        if (cube.timeStopped) {
+            cube.timeStopTimer-=deltaTime;
+            if (cube.timeStopTimer<0) {
+                cube.timeStopped=false;
+                cube.timeStopTimer=0;
+            }
+        }
+        else {
+            for (auto &block : pushableBlocks) {
+                if (block.resetQueued) {
+                    block.resetQueued=false;
+                    block.resetPosition();
+                }
+            }
+        }
+    }
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        return mixState(mixState(STATE_HASH_START, cube.timeStopped), milliseconds(cube.timeStopTimer));
+    }
+};
+
+// Fnaf puzzle
+class FiveNightsBehavior : public LevelBehavior {
+public:
+    void update(Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                std::vector<Spike> &spikes, double deltaTime, bool &dead) override {
+        if (!cube.powerOut) {
+            cube.drain+=cube.drainRate*deltaTime;
+            if (cube.drain>=cube.drainRate) {
+                cube.powerPercent-=cube.drainRate;
+                cube.drain=0;
+            }
+        }
+        if (cube.powerPercent==0) {
+            cube.powerOut=true;
+        }
+        if (cube.powerOut && !cube.diedFromPowerOut) {
+            playMusic(MUSIC_FNAF, 0);
+            cube.diedFromPowerOut=true;
+        }
+        if (!isMusicPlaying()) dead=true;
+    }
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactFiveNights(blocks, cube.powerPercent);
+    }
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        uint64_t hash=mixState(STATE_HASH_START, cube.powerPercent);
+        hash=mixState(hash, milliseconds(cube.drain));
+        hash=mixState(hash, cube.powerOut);
+        return mixState(hash, milliseconds(musicTime()));
+    }
+    // Power drains out, then the song plays to the end
+    double waitSeconds(const Player &cube) const override {
+        return double(cube.powerPercent)/cube.drainRate+FNAF_SONG_LENGTH;
+    }
+};
+
+class TicTacToeBehavior : public LevelBehavior {
+public:
+    // Put the cursor block between the cells
+    void reset(std::vector<Block> &blocks) override {
+        for (auto &block : blocks) {
+            if (block.getType()==TILE_1XM) block.offsetPosition(TILE_SIZE/2, 0);
+        }
+    }
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactTicTacToe(blocks, spikes);
+    }
+    // The board only, the cursor would leave too many places to search and just picks where the next X goes
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        return mixState(STATE_HASH_START, ticTacToe.x|uint64_t(ticTacToe.o)<<9);
+    }
+};
+
+// Jojo reference
+class StarOnShoulderBehavior : public LevelBehavior {
+public:
+    void update(Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                std::vector<Spike> &spikes, double deltaTime, bool &dead) override {
+        if (cube.cutscenePlaying && !cube.roundaboutPlaying) {
+            playMusic(MUSIC_ROUNDABOUT, 0);
+            cube.roundaboutPlaying=true;
+        }
+        cube.levelFreeze=false;
+        for (const auto &block : blocks) {
+            if (block.getType()==TILE_3ADM && block.getHitbox().y>SCREEN_HEIGHT-3*TILE_SIZE) {
+                if (isMusicPlaying()) cube.levelFreeze=true;
+            }
+        }
+        if (!isMusicPlaying()) {
+            cube.cutscenePlaying=false;
+            cube.levelFreeze=false;
+        }
+    }
+    void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, double deltaTime) override {
+        block.interactJojo(blocks, spikes, cube.cutscenePlaying);
+    }
+    uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const override {
+        uint64_t hash=mixState(STATE_HASH_START, cube.cutscenePlaying);
+        hash=mixState(hash, cube.roundaboutPlaying);
+        return mixState(hash, milliseconds(musicTime()));
+    }
+};
+
+// Flipped input
+class VertigoBehavior : public LevelBehavior {
+public:
+    bool flipsInput() const override { return true; }
+};
+
+static LevelBehavior noBehavior;
+static CookiesBehavior cookiesBehavior;
+static EnigmaBehavior enigmaBehavior;
+static MoveToDieBehavior moveToDieBehavior;
+static IllusionWorldBehavior illusionWorldBehavior;
+static FiveNightsBehavior fiveNightsBehavior;
+static TicTacToeBehavior ticTacToeBehavior;
+static StarOnShoulderBehavior starOnShoulderBehavior;
+static VertigoBehavior vertigoBehavior;
+
+static const struct {
+    const char *levelName;
+    LevelBehavior *behavior;
+} behaviorTable[]={
+    {"Cookies", &cookiesBehavior},
+    {"Enigma", &enigmaBehavior},
+    {"Move to Die", &moveToDieBehavior},
+    {"Illusion World", &illusionWorldBehavior},
+    {"Five Nights", &fiveNightsBehavior},
+    {"Tic Tac Toe", &ticTacToeBehavior},
+    {"Star on Shoulder", &starOnShoulderBehavior},
+    {"Vertigo", &vertigoBehavior}
+};
+
+LevelBehavior *currentBehavior=&noBehavior;
+
+LevelBehavior &findLevelBehavior(const std::string &levelName) {
+    for (const auto &entry : behaviorTable) {
+        if (levelName==entry.levelName) return *entry.behavior;
+    }
+    return noBehavior;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LevelObjs.h"
+
+class Player;
+
+// Gimmicks of one level, looked up once when the level starts so a tick never compares level names
+// The base class is a level without gimmicks, every hook does nothing
+class LevelBehavior {
+public:
+    virtual ~LevelBehavior() {}
+
+    // Level was just loaded or restarted
+    virtual void reset(std::vector<Block> &blocks) {}
+
+    // Left and right are swapped
+    virtual bool flipsInput() const { return false; }
+
+    // Once per tick before orbs and pads are checked
+    virtual void update(Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                        std::vector<Spike> &spikes, double deltaTime, bool &dead) {}
+
+    // Player hit an interactable block that isn't a menu button
+    virtual void interact(Block &block, Player &cube, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                          std::vector<Spike> &spikes, double deltaTime) {}
+
+    // Real time the ticks skipped (hitch, minimized window), for levels that keep running on their own
+    virtual void catchUp(Player &cube, double seconds) {}
+
+    // Level state the player and object positions don't show (power left, the board, the money), for the solver
+    // Places that differ only here aren't the same place
+    virtual uint64_t stateHash(const Player &cube, const std::vector<Block> &blocks) const { return 0; }
+
+    // Seconds the level takes to end on its own when the player just waits, 0 if it never does
+    virtual double waitSeconds(const Player &cube) const { return 0; }
+};
+
+// Behavior of the level in the object vectors, set by startLevel
+extern LevelBehavior *currentBehavior;
+
+// Behavior of a level by name, levels without gimmicks (and the menu) share the base one
+LevelBehavior &findLevelBehavior(const std::string &levelName);
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "LevelFormat.h"
+
+// Check if a stream starts with the compiled level magic
+bool isCompiledLevel(std::istream &file) {
+    char magic[4]={};
+    file.read(magic, sizeof(magic));
+    bool compiled=file.gcount()==sizeof(magic) && memcmp(magic, LEVEL_FILE_MAGIC, sizeof(magic))==0;
+    file.clear();
+    file.seekg(0);
+    return compiled;
+}
+
+// Get the tile type of a record, it has to be the right kind and agree with the token
+static bool readTileType(const LevelFileTile &tile, uint32_t kind, TileType &type) {
+    if (tile.tileType==TILE_NONE || tile.tileType>=TILE_COUNT) return false;
+    const TileInfo &info=tileInfo[tile.tileType];
+    if (!(info.flags&kind) || strncmp(info.name, tile.type, sizeof(tile.type))!=0) return false;
+    type=TileType(tile.tileType);
+    return true;
+}
+
+// Read a compiled level
+bool loadCompiledLevel(std::istream &file, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                       std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads) {
+    // Read the whole file in one go
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize=file.tellg();
+    file.seekg(0);
+    if (fileSize<(std::streamoff)sizeof(LevelFileHeader)) {
+        std::cout << "Compiled level file is too small." << std::endl;
+        return false;
+    }
+    std::vector<char> data(fileSize);
+    if (!file.read(data.data(), fileSize)) {
+        std::cout << "Failed to read compiled level file." << std::endl;
+        return false;
+    }
+
+    LevelFileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, LEVEL_FILE_MAGIC, sizeof(header.magic))!=0 || header.version!=LEVEL_FILE_VERSION ||
+        header.headerSize!=sizeof(LevelFileHeader)) {
+        std::cout << "Unsupported compiled level version." << std::endl;
+        return false;
+    }
+
+    // Make sure the counts match the file size before touching any record
+    uint64_t expectedSize=sizeof(LevelFileHeader)+
+                          uint64_t(header.blockCount)*sizeof(LevelFileTile)+
+                          uint64_t(header.pushableBlockCount)*sizeof(LevelFileBox)+
+                          uint64_t(header.spikeCount)*sizeof(LevelFileTile)+
+                          uint64_t(header.jumpOrbCount)*sizeof(LevelFileOrb)+
+                          uint64_t(header.jumpPadCount)*sizeof(LevelFileTile);
+    if (expectedSize!=uint64_t(fileSize)) {
+        std::cout << "Compiled level file is corrupted." << std::endl;
+        return false;
+    }
+
+    blocks.clear(); pushableBlocks.clear(); spikes.clear(); jumpOrbs.clear(); jumpPads.clear();
+    blocks.reserve(header.blockCount);
+    pushableBlocks.reserve(header.pushableBlockCount);
+    spikes.reserve(header.spikeCount);
+    jumpOrbs.reserve(header.jumpOrbCount);
+    jumpPads.reserve(header.jumpPadCount);
+
+    const char *cursor=data.data()+sizeof(LevelFileHeader);
+    TileType type;
+    for (uint32_t i=0; i<header.blockCount; i++, cursor+=sizeof(LevelFileTile)) {
+        LevelFileTile tile;
+        memcpy(&tile, cursor, sizeof(tile));
+        if (!readTileType(tile, FLAG_BLOCK, type)) {
+            std::cout << "Compiled level file has an unknown block type." << std::endl;
+            return false;
+        }
+        blocks.emplace_back(tile.x, tile.y, tile.w, tile.h, tile.rotation, SDL_RendererFlip(tile.flip), type);
+    }
+    for (uint32_t i=0; i<header.pushableBlockCount; i++, cursor+=sizeof(LevelFileBox)) {
+        LevelFileBox box;
+        memcpy(&box, cursor, sizeof(box));
+        pushableBlocks.emplace_back(box.x, box.y, box.w, box.h);
+    }
+    for (uint32_t i=0; i<header.spikeCount; i++, cursor+=sizeof(LevelFileTile)) {
+        LevelFileTile tile;
+        memcpy(&tile, cursor, sizeof(tile));
+        if (!readTileType(tile, FLAG_SPIKE, type)) {
+            std::cout << "Compiled level file has an unknown spike type." << std::endl;
+            return false;
+        }
+        spikes.emplace_back(tile.x, tile.y, tile.w, tile.h, tile.rotation, SDL_RendererFlip(tile.flip), type);
+    }
+    for (uint32_t i=0; i<header.jumpOrbCount; i++, cursor+=sizeof(LevelFileOrb)) {
+        LevelFileOrb orb;
+        memcpy(&orb, cursor, sizeof(orb));
+        if (jumpOrbLookup.find(std::string(1, orb.type))==jumpOrbLookup.end()) {
+            std::cout << "Compiled level file has an unknown jump orb type." << std::endl;
+            return false;
+        }
+        jumpOrbs.emplace_back(orb.x, orb.y, orb.w, orb.h, orb.type);
+    }
+    for (uint32_t i=0; i<header.jumpPadCount; i++, cursor+=sizeof(LevelFileTile)) {
+        LevelFileTile tile;
+        memcpy(&tile, cursor, sizeof(tile));
+        if (!readTileType(tile, FLAG_PAD, type)) {
+            std::cout << "Compiled level file has an unknown jump pad type." << std::endl;
+            return false;
+        }
+        jumpPads.emplace_back(tile.x, tile.y, tile.w, tile.h, tile.rotation, type);
+    }
+
+    return true;
+}
+
+// Fill a tile record, the tile type has to be the right kind and its token has to fit in the padded field
+static bool makeTile(LevelFileTile &tile, const SDL_FRect &hitbox, double rotation, SDL_RendererFlip flip, TileType type, uint32_t kind) {
+    if (type==TILE_NONE || type>=TILE_COUNT || !(tileInfo[type].flags&kind)) return false;
+    size_t nameLength=strlen(tileInfo[type].name);
+    if (nameLength>=sizeof(tile.type)) return false;
+    memset(&tile, 0, sizeof(tile));
+    tile.x=hitbox.x; tile.y=hitbox.y; tile.w=hitbox.w; tile.h=hitbox.h;
+    tile.rotation=int16_t(rotation);
+    tile.flip=uint8_t(flip);
+    memcpy(tile.type, tileInfo[type].name, nameLength);
+    tile.tileType=type;
+    return true;
+}
+
+// Write the objects of a level to a compiled level file
+bool saveCompiledLevel(const std::string &path, const std::vector<Block> &blocks, const std::vector<PushableBlock> &pushableBlocks,
+                       const std::vector<Spike> &spikes, const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads) {
+    std::vector<char> data;
+    auto append=[&data](const void *record, size_t size) {
+        const char *bytes=static_cast<const char*>(record);
+        data.insert(data.end(), bytes, bytes+size);
+    };
+
+    LevelFileHeader header;
+    memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(header.magic));
+    header.version=LEVEL_FILE_VERSION;
+    header.headerSize=sizeof(LevelFileHeader);
+    header.blockCount=blocks.size();
+    header.pushableBlockCount=pushableBlocks.size();
+    header.spikeCount=spikes.size();
+    header.jumpOrbCount=jumpOrbs.size();
+    header.jumpPadCount=jumpPads.size();
+    append(&header, sizeof(header));
+
+    LevelFileTile tile;
+    for (const auto &block : blocks) {
+        if (!makeTile(tile, block.getHitbox(), block.angle, block.mirror, block.getType(), FLAG_BLOCK)) {
+            std::cout << "Unknown block type: " << int(block.getType()) << std::endl;
+            return false;
+        }
+        append(&tile, sizeof(tile));
+    }
+    for (const auto &block : pushableBlocks) {
+        SDL_FRect hitbox=block.getHitbox();
+        LevelFileBox box={hitbox.x, hitbox.y, hitbox.w, hitbox.h};
+        append(&box, sizeof(box));
+    }
+    for (const auto &spike : spikes) {
+        if (!makeTile(tile, spike.getHitbox(), spike.angle, spike.mirror, spike.getType(), FLAG_SPIKE)) {
+            std::cout << "Unknown spike type: " << int(spike.getType()) << std::endl;
+            return false;
+        }
+        append(&tile, sizeof(tile));
+    }
+    for (const auto &orb : jumpOrbs) {
+        if (jumpOrbLookup.find(std::string(1, orb.getType()))==jumpOrbLookup.end()) {
+            std::cout << "Unknown jump orb type: " << orb.getType() << std::endl;
+            return false;
+        }
+        const SDL_FRect &hitbox=orb.getHitbox();
+        LevelFileOrb record={hitbox.x, hitbox.y, hitbox.w, hitbox.h, orb.getType(), {0, 0, 0}};
+        append(&record, sizeof(record));
+    }
+    for (const auto &pad : jumpPads) {
+        if (!makeTile(tile, pad.getHitbox(), pad.angle, SDL_FLIP_NONE, pad.getType(), FLAG_PAD)) {
+            std::cout << "Unknown jump pad type: " << int(pad.getType()) << std::endl;
+            return false;
+        }
+        append(&tile, sizeof(tile));
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open() || !file.write(data.data(), data.size())) {
+        std::cout << "Failed to write compiled level file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Convert one text level
+bool compileLevel(const std::string &textPath, const std::string &compiledPath) {
+    std::vector<Block> levelBlocks;
+    std::vector<PushableBlock> levelPushableBlocks;
+    std::vector<Spike> levelSpikes;
+    std::vector<JumpOrb> levelJumpOrbs;
+    std::vector<JumpPad> levelJumpPads;
+
+    if (!loadLevel(textPath, levelBlocks, levelPushableBlocks, levelSpikes, levelJumpOrbs, levelJumpPads)) return false;
+    if (!saveCompiledLevel(compiledPath, levelBlocks, levelPushableBlocks, levelSpikes, levelJumpOrbs, levelJumpPads)) return false;
+
+    std::cout << textPath << " -> " << compiledPath << " (" << levelBlocks.size() << " blocks, " << levelPushableBlocks.size()
+              << " pushable blocks, " << levelSpikes.size() << " spikes, " << levelJumpOrbs.size() << " orbs, "
+              << levelJumpPads.size() << " pads)" << std::endl;
+    return true;
+}
+
+// Convert every level the game knows about, returns a process exit code
+int compileAllLevels() {
+    std::vector<std::string> names(levelName, levelName+ALL_LEVELS);
+    names.push_back("Menu");
+    names.push_back("Settings");
+
+    int failed=0;
+    for (const auto &name : names) {
+        std::string textPath="Resources/Levels/"+name+LEVEL_TEXT_EXTENSION;
+        std::ifstream exists(textPath);
+        if (!exists.is_open()) continue; // Not every level has a file (The Hub)
+        exists.close();
+        if (!compileLevel(textPath, "Resources/Levels/"+name+LEVEL_COMPILED_EXTENSION)) failed++;
+    }
+    return failed==0 ? 0 : 1;
+}
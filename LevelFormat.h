@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "LevelObjs.h"
+
+// Compiled level file (.dtwl), written by the level compiler and read by loadLevel
+// Layout: header, then every record of each object kind back to back in header order
+// All values are stored little-endian, exactly as the structs below are laid out in memory
+
+const char LEVEL_FILE_MAGIC[4]={'D', 'T', 'W', 'L'};
+const uint16_t LEVEL_FILE_VERSION=3;
+
+struct LevelFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t blockCount;
+    uint32_t pushableBlockCount;
+    uint32_t spikeCount;
+    uint32_t jumpOrbCount;
+    uint32_t jumpPadCount;
+};
+
+// Blocks, spikes and jump pads
+struct LevelFileTile {
+    float x, y, w, h;   // Hitbox, already offset for the object's shape
+    int16_t rotation;   // Degrees
+    uint8_t flip;       // SDL_RendererFlip
+    uint8_t reserved;   // Zero, the sprite clip comes from the tile type when loading
+    char type[8];       // Level file token, zero padded
+    uint8_t tileType;   // TileType, checked against the token when loading
+    uint8_t padding[3];
+};
+
+// Jump orbs
+struct LevelFileOrb {
+    float x, y, w, h;
+    char type;
+    uint8_t padding[3];
+};
+
+// Pushable blocks
+struct LevelFileBox {
+    float x, y, w, h;
+};
+
+static_assert(sizeof(LevelFileHeader)==28, "Level file header must be tightly packed");
+static_assert(sizeof(LevelFileTile)==32, "Level file tile must be tightly packed");
+static_assert(sizeof(LevelFileOrb)==20, "Level file orb must be tightly packed");
+static_assert(sizeof(LevelFileBox)==16, "Level file box must be tightly packed");
+
+// Check if a stream starts with the compiled level magic, stream is rewound either way
+bool isCompiledLevel(std::istream &file);
+
+// Read a compiled level, every size is checked against the file before anything is copied
+bool loadCompiledLevel(std::istream &file, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                       std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads);
+
+// Write the objects of a level to a compiled level file
+bool saveCompiledLevel(const std::string &path, const std::vector<Block> &blocks, const std::vector<PushableBlock> &pushableBlocks,
+                       const std::vector<Spike> &spikes, const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads);
+
+// Level compiler: convert one text level, or every level the game knows about
+bool compileLevel(const std::string &textPath, const std::string &compiledPath);
+int compileAllLevels();
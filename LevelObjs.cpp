@@ -4,34 +4,41 @@
 #include <cmath>
 #include <algorithm>
 #include <random>
-#include <ctime>
 #include <SDL.h>
-#include <SDL_ttf.h>
-#include <SDL_image.h>
-#include "Texture.h"
 #include "LevelObjs.h"
 #include "Player.h"
+#include "BlockGrid.h"
+#include "SurfaceIndex.h"
 #include "Enums.h"
+#include "Profiler.h"
+#include "LevelBehavior.h"
+#include "LoadLevel.h"
 
-extern SDL_Renderer *gRenderer;
-extern LTexture instructionTexture[];
-extern TTF_Font *gSmallFont;
-extern SDL_Color textColor;
+// Hitbox between the position at the start of the tick and the current one
+static SDL_FRect interpolateHitbox(const SDL_FRect &hitbox, float prevX, float prevY, double alpha) {
+    return {static_cast<float>(prevX+(hitbox.x-prevX)*alpha), static_cast<float>(prevY+(hitbox.y-prevY)*alpha), hitbox.w, hitbox.h};
+}
+
+unsigned int staticRevision=0;
 
 /// Block functions start
 
-Block::Block(float x, float y, float w, float h, double a, SDL_RendererFlip m, const std::string &type) {
+Block::Block(float x, float y, float w, float h, double a, SDL_RendererFlip m, TileType type) {
     hitbox={x, y, w, h};
-    realX=x, realY=y;
+    prevX=x, prevY=y;
+    mover.targetX=x, mover.targetY=y;
+    mover.horizontal=(type==TILE_1Y);
     angle=a;
     blockType=type;
+    flags=tileInfo[type].flags;
     mirror=m;
+    dynamic=(flags&(FLAG_INTERACTABLE|FLAG_TIC_TAC_TOE_CELL|FLAG_ENIGMA_DISPLAY|FLAG_CLICKER_UPGRADE))!=0;
 }
 
 // Updated to account for moving blocks
 bool Block::checkXCollision(double &playerX, double playerY, double &nextPlayerX,
                             double playerVelX, int PLAYER_WIDTH, int PLAYER_HEIGHT) const {
-    if (blockType[1]=='J') return false;
+    if (flags&FLAG_JUMP_THROUGH) return false;
 
     bool collided=false;
 
@@ -97,7 +104,7 @@ bool Block::checkYCollision(double playerX, double &playerY, double &nextPlayerY
         nextPlayerY<=hitbox.y+hitbox.h && // If player will go through platform
         playerX+PLAYER_WIDTH>hitbox.x &&
         playerX<hitbox.x+hitbox.w && // And will collide with platform
-        blockType[1]!='J') { // Ignore jump-through blocks
+        !(flags&FLAG_JUMP_THROUGH)) { // Ignore jump-through blocks
 
         nextPlayerY=hitbox.y+hitbox.h;
         collided=true;
@@ -116,267 +123,196 @@ const SDL_FRect &Block::getHitbox() const {
     return hitbox;
 }
 
-const std::string &Block::getType() const {
+TileType Block::getType() const {
     return blockType;
 }
-void Block::switchType(std::string newType) {
+void Block::switchType(TileType newType) {
     blockType=newType;
+    flags=tileInfo[newType].flags;
+    markSurfaceChanged(*this);
+    markDynamic();
 }
 
-void Block::movingBlockX(double deltaTime) {
-    if (unlocked) {
-        hitbox.y=realY;
-        float dx=realX-hitbox.x;
-        float distance=fabs(dx);
-        if (distance<1.0f) {
-            hitbox.x=realX;
-            unlocked=false;
-        }
-        else {
-            float moveStep=speed*deltaTime;
-            hitbox.x+=dx/distance*moveStep;
-        }
-    }
+bool Block::hasFlag(uint32_t flag) const {
+    return (flags&flag)!=0;
 }
-void Block::movingBlockY(double deltaTime) {
-    if (unlocked) {
-        hitbox.x=realX;
-        float dy=realY-hitbox.y;
-        float distance=fabs(dy);
-        if (distance<1.0f) {
-            hitbox.y=realY;
-            unlocked=false;
-        }
-        else {
-            float moveStep=speed*deltaTime;
-            hitbox.y+=dy/distance*moveStep;
-        }
-    }
-}
-void Block::changeSpeed(float change) {
-    speed*=change;
+
+bool Block::updateMover(double deltaTime) {
+    markBlockMoved(*this);
+    markSurfaceChanged(*this);
+    markDynamic();
+    return mover.step(hitbox, deltaTime);
 }
 void Block::offsetPosition(float offsetX, float offsetY) {
     hitbox.x+=offsetX;
     hitbox.y+=offsetY;
+    markBlockMoved(*this);
+    markSurfaceChanged(*this);
+    markDynamic();
+}
+
+void Block::savePosition() {
+    prevX=hitbox.x;
+    prevY=hitbox.y;
+}
+SDL_FRect Block::getRenderHitbox(double alpha) const {
+    return interpolateHitbox(hitbox, prevX, prevY, alpha);
+}
+
+bool Block::isDynamic() const {
+    return dynamic;
+}
+void Block::markDynamic() {
+    if (dynamic) return;
+    dynamic=true;
+    staticRevision++;
 }
 
 bool Block::isInteractable() const {
-    std::string type[16]={"1I1", "1I2", "1I3", "1I4", "1IP", "1S", "1P", "1C", "1BI", "1IN",
-                        "1R", "1SA", "1ZA", "1XM", "1XI", "1WVI"};
-    for (int i=0; i<16; i++) {
-        if (blockType==type[i]) return true;
-    }
-    return false;
+    return (flags&FLAG_INTERACTABLE)!=0;
 }
-void Block::interact(unsigned long long &totalMoney, int &gainPerHit, int &passiveIncome, GameStatus &currentStatus,
-                     std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-                     const std::string &levelName, double deltaTime, bool &timeStopped, double &timeStopTimer, int &powerPercent, bool &cutscenePlaying) {
+void Block::interact(Player &cube, GameStatus &currentStatus, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                     std::vector<Spike> &spikes, LevelBehavior &behavior, double deltaTime) {
     if (!isInteractable()) return;
-    if (blockType=="1S") {
+    PROFILE_SPAN_DETAIL("Block::interact", tileInfo[blockType].name);
+    if (blockType==TILE_1S) {
         currentStatus=SETTINGS;
     }
-    else if (blockType=="1P") {
+    else if (blockType==TILE_1P) {
         currentStatus=START;
     }
-    else if (blockType=="1C") {
+    else if (blockType==TILE_1C) {
         currentStatus=CREDITS;
     }
-    else if (levelName=="Cookies") {
-        interactClicker(totalMoney, gainPerHit, passiveIncome, blocks, spikes, deltaTime);
-    }
-    else if (levelName=="Enigma") {
-        interactEnigma(blocks, spikes);
-    }
-    else if (levelName=="Move to Die" || levelName=="Illusion World") {
-        interactMoveToDie(blocks, pushableBlocks, timeStopped, timeStopTimer);
-    }
-    else if (levelName=="Five Nights") {
-        interactFiveNights(blocks, powerPercent);
-    }
-    else if (levelName=="Tic Tac Toe") {
-        interactTicTacToe(blocks, spikes);
-    }
-    else if (levelName=="Star on Shoulder") {
-        interactJojo(blocks, spikes, cutscenePlaying);
+    else {
+        behavior.interact(*this, cube, blocks, pushableBlocks, spikes, deltaTime);
     }
 }
 
 // Helper function for level: Cookies
-void Block::interactClicker(unsigned long long &totalMoney, int &gainPerHit, int &passiveIncome,
-                            std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime) {
+void Block::interactClicker(Economy &economy, std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime) {
     // Spike to kill player (duh)
     if (spikes.empty()) {
         int baseX, baseY;
         for (const auto &block : blocks) {
-            if (block.getType()=="1PD") {
+            if (block.getType()==TILE_1PD) {
                 baseX=block.getHitbox().x;
                 baseY=block.getHitbox().y;
             }
         }
-        spikes.emplace_back(baseX+TILE_SIZE*2/5.0f, baseY+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, "2ED");
+        spikes.emplace_back(baseX+TILE_SIZE*2/5.0f, baseY+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, TILE_2ED);
     }
 
-    if (blockType=="1IP") { // Point block
-        speed=50.0f;
-        totalMoney+=gainPerHit;
+    if (blockType==TILE_1IP) { // Point block
+        mover.speed=50.0f;
+        economy.click();
     }
 
-    else if (blockType=="1I2") { // Lower point block position
-        if (counter>=5) counter=5;
-        else {
-            if (totalMoney>=(unsigned long long)value) {
-                for (auto &block : blocks) {
-                    if (block.getType()=="1IP") {
-                        block.unlocked=true;
-                        block.realY=block.getHitbox().y+TILE_SIZE/4;
-                    }
+    else if (blockType==TILE_1I2) { // Lower point block position
+        if (economy.buy(UPGRADE_POSITION)) {
+            for (auto &block : blocks) {
+                if (block.getType()==TILE_1IP) {
+                    startMoving(blocks, block, block.mover.targetX, block.getHitbox().y+TILE_SIZE/4);
                 }
-                totalMoney-=value;
-                if (counter==0) value*=100;
-                else value*=4;
-                counter++;
             }
         }
     }
 
-    else if (blockType=="1I3") { // Increase gain per hit
-        if (counter>=25) counter=25;
-        else {
-            if (totalMoney>=(unsigned long long)value) {
-                if (counter==0) gainPerHit*=5;
-                else {
-                    gainPerHit+=increment;
-                    increment=value/counter;
-                }
-                totalMoney-=value;
-                value*=2;
-                counter++;
-            }
-        }
+    else if (blockType==TILE_1I3) { // Increase gain per hit
+        economy.buy(UPGRADE_GAIN);
     }
 
-    else if (blockType=="1I4") { // Increase passive income
-        if (counter>=25) counter=25;
-        else {
-            if (totalMoney>=(unsigned long long)value) {
-                if (counter==0) passiveIncome=1;
-                else if (counter==1) passiveIncome=5;
-                else {
-                    passiveIncome+=increment;
-                    increment=(value/counter)/2;
-                }
-                totalMoney-=value;
-                if (counter<10) value*=3;
-                else value*=2;
-                counter++;
-            }
-        }
+    else if (blockType==TILE_1I4) { // Increase passive income
+        economy.buy(UPGRADE_PASSIVE);
     }
 }
 
 // Helper function for level: Enigma
-// Generate random password
-std::vector<int> enigmaPassword;
-void generateEnigmaPassword() {
-    std::vector<int> digits={0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
-
-    std::mt19937 g(static_cast<unsigned int>(time(0)));
-    std::shuffle(digits.begin(), digits.end(), g);
+// Random numbers for level puzzles, seeded when a level starts so replays get the same password and bot moves
+std::mt19937 levelRandom;
 
-    enigmaPassword=std::vector<int>(digits.begin(), digits.begin()+4);
-}
+// Password of this attempt, made from levelRandom the first time the level is touched
+static EnigmaCode enigmaPassword;
+static bool enigmaPasswordReady=false;
 
 bool uniqueDigitsInPassword=true;
+EnigmaSolver enigmaSolver;
+bool enigmaHints=false;
+
+// Digit blocks in level order, found again when a level is loaded
+static size_t digitBlocks[ENIGMA_DIGITS];
+static const void *digitSource=nullptr;
+static unsigned int digitRevision=0;
+
+static bool findDigitBlocks(const std::vector<Block> &blocks) {
+    if (digitSource==&blocks && digitRevision==levelRevision) return true;
+    int digit=0;
+    for (size_t i=0; i<blocks.size() && digit<ENIGMA_DIGITS; i++) {
+        if (blocks[i].getType()==TILE_1BI) digitBlocks[digit++]=i;
+    }
+    if (digit<ENIGMA_DIGITS) return false;
+    digitSource=&blocks;
+    digitRevision=levelRevision;
+    return true;
+}
 
 void Block::interactEnigma(std::vector<Block> &blocks, std::vector<Spike> &spikes) {
     // Spikes to kill player (duh)
     if (spikes.empty()) {
         for (int i=0; i<3; i++) {
-            spikes.emplace_back(800+TILE_SIZE*2/5.0f, 800+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, "2EU");
+            spikes.emplace_back(800+TILE_SIZE*2/5.0f, 800+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, TILE_2EU);
         }
     }
 
     // Generate password
-    if (enigmaPassword.empty()) generateEnigmaPassword();
+    if (!enigmaPasswordReady) {
+        enigmaPassword=generateEnigmaCode(levelRandom);
+        enigmaPasswordReady=true;
+        enigmaSolver.reset();
+    }
 
-    if (blockType=="1BI") { // Password digit block
+    if (blockType==TILE_1BI) { // Password digit block
         counter=(counter+1)%10;
     }
 
-    else if (blockType=="1IN") { // Check solution block
-        // Pointer vector to digit blocks
-        std::vector<Block*> digits(4, nullptr);
-        int n=0;
-        for (auto &block : blocks) {
-            if (block.getType()=="1BI") {
-                digits[n]=&block;
-                n++;
-            }
-        }
+    else if (blockType==TILE_1IN) { // Check solution block
+        if (!findDigitBlocks(blocks)) return;
 
-        // Check if all digits in solution are unique
-        if (digits.size()!=enigmaPassword.size()) return;
-        for (int i=0; i<int(digits.size())-1; i++) {
-            for (int j=i+1; j<int(digits.size()); j++) {
-                if (digits[i]->counter==digits[j]->counter) {
-                    uniqueDigitsInPassword=false;
-                    return;
-                }
-            }
-        }
-        uniqueDigitsInPassword=true;
-
-        // Setup for solution check
-        int correctPos=0, wrongPos=0;
-        std::vector<bool> passwordUsed(enigmaPassword.size(), false);
-        std::vector<bool> guessUsed(digits.size(), false);
-
-        // Check for digits in correct position
-        for (int i=0; i<int(digits.size()); i++) {
-            if (digits[i]->counter==enigmaPassword[i]) {
-                correctPos++;
-                passwordUsed[i]=guessUsed[i]=true;
-            }
-        }
+        // All digits in the solution have to be different
+        int digits[ENIGMA_DIGITS];
+        for (int i=0; i<ENIGMA_DIGITS; i++) digits[i]=blocks[digitBlocks[i]].counter;
+        EnigmaCode guess;
+        uniqueDigitsInPassword=makeEnigmaCode(digits, guess);
+        if (!uniqueDigitsInPassword) return;
 
-        // Check for digits in wrong position but is in password
-        for (int i=0; i<int(digits.size()); i++) {
-            if (guessUsed[i]) continue;
-            for (int j=0; j<int(enigmaPassword.size()); j++) {
-                if (!passwordUsed[j] && digits[i]->counter==enigmaPassword[j]) {
-                    wrongPos++;
-                    passwordUsed[j]=true;
-                    break;
-                }
-            }
-        }
+        int score=scoreEnigma(guess, enigmaPassword);
+        enigmaSolver.addCheck(guess, score);
+        if (enigmaHints) enigmaSolver.bestGuess(); // Searched here once, the hint text only reads it
 
         // Render to screen
         for (auto &block : blocks) {
-            if (block.getType()=="1BG") {
-                block.counter=correctPos;
+            if (block.getType()==TILE_1BG) {
+                block.counter=score/5;
             }
-            else if (block.getType()=="1BO") {
-                block.counter=wrongPos;
+            else if (block.getType()==TILE_1BO) {
+                block.counter=score%5;
             }
         }
 
         // Move spikes if player wins
-        if (correctPos==4) {
+        if (score==ENIGMA_SOLVED) {
             for (int i=0; i<3; i++) {
-                spikes[i].unlocked=true;
-                spikes[i].realX=SCREEN_WIDTH-(i+1)*TILE_SIZE-TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f;
-                spikes[i].realY=SCREEN_HEIGHT-TILE_SIZE*3/2.0f+TILE_SIZE*3/10.0f;
+                startMoving(spikes, spikes[i], SCREEN_WIDTH-(i+1)*TILE_SIZE-TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f,
+                            SCREEN_HEIGHT-TILE_SIZE*3/2.0f+TILE_SIZE*3/10.0f);
             }
-            enigmaPassword.clear();
+            enigmaPasswordReady=false;
         }
     }
 }
 
 // Helper function for level: Move to Die + Illusion World
 void Block::interactMoveToDie(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, bool &timeStopped, double &timeStopTimer) {
-    if (blockType=="1R") { // Reset pushable block position
+    if (blockType==TILE_1R) { // Reset pushable block position
         for (auto &block : pushableBlocks) {
             if (timeStopped) {
                 block.resetQueued=true;
@@ -387,7 +323,7 @@ void Block::interactMoveToDie(std::vector<Block> &blocks, std::vector<PushableBl
         }
     }
 
-    else if (blockType=="1SA") { // Time stop
+    else if (blockType==TILE_1SA) { // Time stop
         if (!timeStopped) {
             timeStopped=true;
             timeStopTimer=5;
@@ -397,76 +333,79 @@ void Block::interactMoveToDie(std::vector<Block> &blocks, std::vector<PushableBl
 
 // Helper function for level: Five Nights
 void Block::interactFiveNights(std::vector<Block> &blocks, int &powerPercent) {
-    if (blockType=="1ZA") { // Lose power
+    if (blockType==TILE_1ZA) { // Lose power
         if (powerPercent>=5) {
             powerPercent-=5;
         }
         else powerPercent=0;
 
         for (auto &block : blocks) { // Move the 2 power blocks
-            if (block.getType()=="1ZA") {
-                if (powerPercent>0) block.unlocked=true;
-                if (block.realY<SCREEN_HEIGHT-4*TILE_SIZE) {
-                    block.realY+=2*TILE_SIZE;
+            if (block.getType()==TILE_1ZA) {
+                float targetY=block.mover.targetY;
+                if (targetY<SCREEN_HEIGHT-4*TILE_SIZE) {
+                    targetY+=2*TILE_SIZE;
                 }
                 else {
-                    block.realY-=2*TILE_SIZE;
+                    targetY-=2*TILE_SIZE;
                 }
+                if (powerPercent>0) startMoving(blocks, block, block.mover.targetX, targetY);
+                else block.mover.targetY=targetY;
             }
         }
     }
 }
 
-// Helper function for level: Tic Tac Toe (simple AI)
-bool botWins=false;
-bool playerWins=false;
-bool stalemate=false; // Set outcome
+// Helper function for level: Tic Tac Toe
+TicTacToe ticTacToe;
 
-// Check game status, set outcome
-void checkGameOver (std::vector<std::vector<Block*>> tttBoard, const int &filledTiles, bool &gameOver, bool &playerWins, bool &botWins, bool &stalemate) {
-    for (int r=0; r<3 && !gameOver; r++) { // Row filled with X/O
-        if (tttBoard[r][0]->getType()==tttBoard[r][1]->getType() &&
-            tttBoard[r][0]->getType()==tttBoard[r][2]->getType() &&
-            (tttBoard[r][0]->getType()=="1X" || tttBoard[r][0]->getType()=="1O")) {
+// Cell the player's cursor is on
+static int cursorCell=0;
 
-            gameOver=true;
-            if (tttBoard[r][0]->getType()=="1X") playerWins=true;
-            else if (tttBoard[r][0]->getType()=="1O") botWins=true;
-        }
-    }
-    for (int c=0; c<3 && !gameOver; c++) { // Column filled with X/O
-        if (tttBoard[0][c]->getType()==tttBoard[1][c]->getType() &&
-            tttBoard[0][c]->getType()==tttBoard[2][c]->getType() &&
-            (tttBoard[0][c]->getType()=="1X" || tttBoard[0][c]->getType()=="1O")) {
-
-            gameOver=true;
-            if (tttBoard[0][c]->getType()=="1X") playerWins=true;
-            else if (tttBoard[0][c]->getType()=="1O") botWins=true;
-        }
-    }
+// Forget the puzzle state of the last attempt, a new password is made when Enigma is entered again
+void resetPuzzleState() {
+    enigmaPasswordReady=false;
+    enigmaSolver.reset();
+    uniqueDigitsInPassword=true;
+    ticTacToe.reset();
+    cursorCell=0;
+}
 
-    // Diagonal filled with X/O
-    if (tttBoard[0][0]->getType()==tttBoard[1][1]->getType() &&
-        tttBoard[0][0]->getType()==tttBoard[2][2]->getType() &&
-        (tttBoard[0][0]->getType()=="1X" || tttBoard[0][0]->getType()=="1O")) {
+// Blocks that show the cells, in level order, found again when a level is loaded
+static size_t cellBlocks[9];
+static const void *cellSource=nullptr;
+static unsigned int cellRevision=0;
 
-        gameOver=true;
-        if (tttBoard[0][0]->getType()=="1X") playerWins=true;
-        else if (tttBoard[0][0]->getType()=="1O") botWins=true;
+static bool findCellBlocks(const std::vector<Block> &blocks) {
+    if (cellSource==&blocks && cellRevision==levelRevision) return true;
+    int cell=0;
+    for (size_t i=0; i<blocks.size() && cell<9; i++) {
+        if (blocks[i].hasFlag(FLAG_TIC_TAC_TOE_CELL)) cellBlocks[cell++]=i;
     }
-    else if (tttBoard[0][2]->getType()==tttBoard[1][1]->getType() &&
-             tttBoard[0][2]->getType()==tttBoard[2][0]->getType() &&
-             (tttBoard[0][2]->getType()=="1X" || tttBoard[0][2]->getType()=="1O")) {
+    if (cell<9) return false;
+    cellSource=&blocks;
+    cellRevision=levelRevision;
+    return true;
+}
 
-        gameOver=true;
-        if (tttBoard[0][2]->getType()=="1X") playerWins=true;
-        else if (tttBoard[0][2]->getType()=="1O") botWins=true;
+// Redraw the cell blocks from the game, only called after something changed
+static void syncBoard(std::vector<Block> &blocks) {
+    bool playing=(ticTacToe.result()==TTT_PLAYING);
+    for (int cell=0; cell<9; cell++) {
+        TileType type=TILE_1E;
+        if ((ticTacToe.x>>cell)&1) type=TILE_1X;
+        else if ((ticTacToe.o>>cell)&1) type=TILE_1O;
+        else if (playing && cell==cursorCell) type=TILE_1B; // Cursor
+        Block &block=blocks[cellBlocks[cell]];
+        if (block.getType()!=type) block.switchType(type);
     }
+}
 
-    // Entire board is filled
-    else if (filledTiles==9) {
-        gameOver=true;
-        stalemate=true;
+// Move the cursor to the next empty cell
+static void advanceCursor() {
+    uint16_t empty=ticTacToe.empty();
+    for (int tries=0; tries<9; tries++) {
+        cursorCell=(cursorCell+1)%9;
+        if ((empty>>cursorCell)&1) return;
     }
 }
 
@@ -474,140 +413,43 @@ void Block::interactTicTacToe(std::vector<Block> &blocks, std::vector<Spike> &sp
     // Spikes to kill player (duh)
     if (spikes.empty()) {
         for (int i=0; i<3; i++) {
-            spikes.emplace_back(800+TILE_SIZE*2/5.0f, 800+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, "2EU");
-        }
-    }
-
-    // Current player position tracker
-    static int currentRow=0;
-    static int currentCol=0;
-
-    // Check game status
-    static int filledTiles=0;
-    static bool gameOver=false;
-
-    // Pointer vector to tic tac toe board
-    std::vector<std::vector<Block*>> tttBoard(3, std::vector<Block*>(3, nullptr));
-    int row=0, col=0;
-    for (auto &block : blocks) {
-        if (block.getType()=="1E" || block.getType()=="1B" || block.getType()=="1X" || block.getType()=="1O") {
-            tttBoard[row][col]=&block;
-            col++;
-            if (col>=3) {
-                col=0;
-                row++;
-            }
+            spikes.emplace_back(800+TILE_SIZE*2/5.0f, 800+TILE_SIZE*3/10.0f, TILE_SIZE/5.0f, TILE_SIZE*2/5.0f, 0, SDL_FLIP_NONE, TILE_2EU);
         }
     }
+    if (!findCellBlocks(blocks)) return;
 
     // Move player position
-    if (blockType=="1XM" && !gameOver) {
-        // Revert current tile to empty
-        if (tttBoard[currentRow][currentCol]->getType()=="1B") {
-            tttBoard[currentRow][currentCol]->switchType("1E");
-        }
-
-        // Skip tiles with X or O block
-        int tries=0;
-        do {
-            currentCol++;
-            if (currentCol>=3) {
-                currentCol=0;
-                currentRow++;
-                if (currentRow>=3) {
-                    currentRow=0;
-                }
-            }
-            tries++;
-        } while ((tttBoard[currentRow][currentCol]->getType()=="1X" || tttBoard[currentRow][currentCol]->getType()=="1O") && tries<9);
-
-        // Change next tile to lined
-        if (tttBoard[currentRow][currentCol]->getType()=="1E") {
-            tttBoard[currentRow][currentCol]->switchType("1B");
-        }
+    if (blockType==TILE_1XM && ticTacToe.result()==TTT_PLAYING) {
+        advanceCursor();
+        syncBoard(blocks);
     }
 
-    // Place X on board
-    else if (blockType=="1XI" && !gameOver) {
-        // Change current tile to X
-        if (tttBoard[currentRow][currentCol]->getType()=="1B") {
-            tttBoard[currentRow][currentCol]->switchType("1X");
-            filledTiles++;
-
-            checkGameOver(tttBoard, filledTiles, gameOver, playerWins, botWins, stalemate);
-
-            // Only allows O move if game is not over
-            if (!gameOver) {
-                // Find empty tiles
-                std::vector<std::pair<int, int>> possibleOMoves;
-                for (int r=0; r<3; r++) {
-                    for (int c=0; c<3; c++) {
-                        if (tttBoard[r][c]->getType()=="1E" || tttBoard[r][c]->getType()=="1B") {
-                            possibleOMoves.push_back({r, c});
-                        }
-                    }
-                }
-
-                // Random O placement
-                if (!possibleOMoves.empty()) {
-                    int pick=rand()%int(possibleOMoves.size());
-                    int oRow=possibleOMoves[pick].first;
-                    int oCol=possibleOMoves[pick].second;
-                    tttBoard[oRow][oCol]->switchType("1O");
-                    filledTiles++;
-                }
-
-                checkGameOver(tttBoard, filledTiles, gameOver, playerWins, botWins, stalemate);
+    // Place X on board, then the bot answers
+    else if (blockType==TILE_1XI && ticTacToe.result()==TTT_PLAYING) {
+        if (ticTacToe.play(cursorCell, true)) {
+            if (ticTacToe.result()==TTT_PLAYING) {
+                ticTacToe.play(pickBotMove(ticTacToe, botDifficulty, levelRandom), false);
 
                 // If AI took player's current position, find the next empty tile
-                if (!gameOver) {
-                    int tries=0;
-                    do {
-                        currentCol++;
-                        if (currentCol>=3) {
-                            currentCol=0;
-                            currentRow++;
-                            if (currentRow>=3) {
-                                currentRow=0;
-                            }
-                        }
-                        tries++;
-                    } while ((tttBoard[currentRow][currentCol]->getType()=="1X" || tttBoard[currentRow][currentCol]->getType()=="1O") && tries<9);
-
-                    if (tttBoard[currentRow][currentCol]->getType()=="1E") {
-                        tttBoard[currentRow][currentCol]->switchType("1B");
-                    }
-                }
+                if (ticTacToe.result()==TTT_PLAYING) advanceCursor();
             }
+            syncBoard(blocks);
         }
     }
 
     // Move spikes if player wins
-    if (playerWins) {
+    if (ticTacToe.result()==TTT_X_WINS) {
         for (int i=0; i<3; i++) {
-            spikes[i].unlocked=true;
-            spikes[i].realX=(i+1)*TILE_SIZE+TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f;
-            spikes[i].realY=SCREEN_HEIGHT-TILE_SIZE*3/2.0f+TILE_SIZE*3/10.0f;
+            startMoving(spikes, spikes[i], (i+1)*TILE_SIZE+TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f,
+                        SCREEN_HEIGHT-TILE_SIZE*3/2.0f+TILE_SIZE*3/10.0f);
         }
     }
 
     // Reset game
-    if (blockType == "1R") {
-        for (int r=0; r<3; r++) {
-            for (int c=0; c<3; c++) {
-                tttBoard[r][c]->switchType("1E");
-                currentCol=0;
-                currentRow=0;
-                if (tttBoard[currentRow][currentCol]->getType()=="1E") {
-                    tttBoard[currentRow][currentCol]->switchType("1B");
-                }
-                playerWins=false;
-                botWins=false;
-                stalemate=false;
-                gameOver=false;
-                filledTiles=0;
-            }
-        }
+    if (blockType == TILE_1R) {
+        ticTacToe.reset();
+        cursorCell=0;
+        syncBoard(blocks);
     }
 }
 
@@ -615,92 +457,65 @@ void Block::interactTicTacToe(std::vector<Block> &blocks, std::vector<Spike> &sp
 void Block::interactJojo(std::vector<Block> &blocks, std::vector<Spike> &spikes, bool &cutscenePlaying) {
     bool blocksAddedAlready=false;
     for (const auto &block : blocks) {
-        if (block.getType()=="1Y") {
+        if (block.getType()==TILE_1Y) {
             blocksAddedAlready=true;
             break;
         }
     }
     if (!blocksAddedAlready) {
         for (int i=0; i<4; i++) {
-            blocks.emplace_back(-TILE_SIZE, i*160, TILE_SIZE, TILE_SIZE, 0, SDL_FLIP_NONE, "1Y");
+            blocks.emplace_back(-TILE_SIZE, i*160, TILE_SIZE, TILE_SIZE, 0, SDL_FLIP_NONE, TILE_1Y);
         }
         for (int i=0; i<4; i++) {
-            blocks.emplace_back(SCREEN_WIDTH, i*160, TILE_SIZE, TILE_SIZE, 0, SDL_FLIP_NONE, "1Y");
+            blocks.emplace_back(SCREEN_WIDTH, i*160, TILE_SIZE, TILE_SIZE, 0, SDL_FLIP_NONE, TILE_1Y);
         }
-        blocks.emplace_back(TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_HORIZONTAL, "3ADM");
-        blocks.emplace_back(2*TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, "3CD");
-        blocks.emplace_back(2*TILE_SIZE, -48000-TILE_SIZE, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, "1BY");
-        blocks.emplace_back(3*TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, "3AD");
+        blocks.emplace_back(TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_HORIZONTAL, TILE_3ADM);
+        blocks.emplace_back(2*TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, TILE_3CD);
+        blocks.emplace_back(2*TILE_SIZE, -48000-TILE_SIZE, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, TILE_1BY);
+        blocks.emplace_back(3*TILE_SIZE, -48000, TILE_SIZE, TILE_SIZE, 180, SDL_FLIP_NONE, TILE_3AD);
     }
     if (spikes.empty()) {
-        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_HORIZONTAL, "2ADM");
-        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE*2, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_NONE, "2CD");
-        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE*3, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_NONE, "2AD");
+        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_HORIZONTAL, TILE_2ADM);
+        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE*2, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_NONE, TILE_2CD);
+        spikes.emplace_back(TILE_SIZE*2/5+TILE_SIZE*3, TILE_SIZE-48000+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, 180, SDL_FLIP_NONE, TILE_2AD);
     }
-    if (blockType=="1WVI") {
+    if (blockType==TILE_1WVI) {
         int leftSide=0, rightSide=0;
         for (auto &block : blocks) {
-            if (block.getType()=="1Y" && !block.unlocked && leftSide<4 && block.realX==-TILE_SIZE) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+7*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-(TILE_SIZE/2+(leftSide+1)*TILE_SIZE);
-                block.changeSpeed(0.2);
+            if (block.getType()==TILE_1Y && !block.mover.active && leftSide<4 && block.mover.targetX==-TILE_SIZE) {
+                startMoving(blocks, block, TILE_SIZE*7/18+7*TILE_SIZE, SCREEN_HEIGHT-(TILE_SIZE/2+(leftSide+1)*TILE_SIZE), 0.2);
                 leftSide++;
             }
         }
         for (auto &block : blocks) {
-            if (block.getType()=="1Y" && !block.unlocked && rightSide<4 && block.realX==SCREEN_WIDTH) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+9*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-(TILE_SIZE/2+(rightSide+1)*TILE_SIZE);
-                block.changeSpeed(0.2);
+            if (block.getType()==TILE_1Y && !block.mover.active && rightSide<4 && block.mover.targetX==SCREEN_WIDTH) {
+                startMoving(blocks, block, TILE_SIZE*7/18+9*TILE_SIZE, SCREEN_HEIGHT-(TILE_SIZE/2+(rightSide+1)*TILE_SIZE), 0.2);
                 rightSide++;
             }
         }
         for (auto &block : blocks) {
-            if (block.getType()=="3ADM" && !block.unlocked) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+7*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-2*TILE_SIZE;
-                block.changeSpeed(10);
+            if (block.getType()==TILE_3ADM && !block.mover.active) {
+                startMoving(blocks, block, TILE_SIZE*7/18+7*TILE_SIZE, SCREEN_HEIGHT-2*TILE_SIZE, 10);
             }
-            else if (block.getType()=="3CD" && !block.unlocked) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+8*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-2*TILE_SIZE;
-                block.changeSpeed(10);
+            else if (block.getType()==TILE_3CD && !block.mover.active) {
+                startMoving(blocks, block, TILE_SIZE*7/18+8*TILE_SIZE, SCREEN_HEIGHT-2*TILE_SIZE, 10);
             }
-            else if (block.getType()=="1BY" && !block.unlocked) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+8*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-3*TILE_SIZE;
-                block.changeSpeed(10);
+            else if (block.getType()==TILE_1BY && !block.mover.active) {
+                startMoving(blocks, block, TILE_SIZE*7/18+8*TILE_SIZE, SCREEN_HEIGHT-3*TILE_SIZE, 10);
             }
-            else if (block.getType()=="3AD" && !block.unlocked) {
-                block.unlocked=true;
-                block.realX=TILE_SIZE*7/18+9*TILE_SIZE;
-                block.realY=SCREEN_HEIGHT-2*TILE_SIZE;
-                block.changeSpeed(10);
+            else if (block.getType()==TILE_3AD && !block.mover.active) {
+                startMoving(blocks, block, TILE_SIZE*7/18+9*TILE_SIZE, SCREEN_HEIGHT-2*TILE_SIZE, 10);
             }
         }
         for (auto &spike : spikes) {
-            if (spike.getType()=="2ADM" && !spike.unlocked) {
-                spike.unlocked=true;
-                spike.realX=TILE_SIZE*7/18+7*TILE_SIZE+TILE_SIZE*2/5;
-                spike.realY=SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10;
-                spike.changeSpeed(10);
+            if (spike.getType()==TILE_2ADM && !spike.mover.active) {
+                startMoving(spikes, spike, TILE_SIZE*7/18+7*TILE_SIZE+TILE_SIZE*2/5, SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10, 10);
             }
-            else if (spike.getType()=="2CD" && !spike.unlocked) {
-                spike.unlocked=true;
-                spike.realX=TILE_SIZE*7/18+8*TILE_SIZE+TILE_SIZE*2/5;
-                spike.realY=SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10;
-                spike.changeSpeed(10);
+            else if (spike.getType()==TILE_2CD && !spike.mover.active) {
+                startMoving(spikes, spike, TILE_SIZE*7/18+8*TILE_SIZE+TILE_SIZE*2/5, SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10, 10);
             }
-            else if (spike.getType()=="2AD" && !spike.unlocked) {
-                spike.unlocked=true;
-                spike.realX=TILE_SIZE*7/18+9*TILE_SIZE+TILE_SIZE*2/5;
-                spike.realY=SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10;
-                spike.changeSpeed(10);
+            else if (spike.getType()==TILE_2AD && !spike.mover.active) {
+                startMoving(spikes, spike, TILE_SIZE*7/18+9*TILE_SIZE+TILE_SIZE*2/5, SCREEN_HEIGHT-TILE_SIZE+TILE_SIZE/10, 10);
             }
         }
         cutscenePlaying=true;
@@ -713,12 +528,14 @@ void Block::interactJojo(std::vector<Block> &blocks, std::vector<Spike> &spikes,
 
 PushableBlock::PushableBlock(float x, float y, float w, float h) {
     hitbox={x, y, w, h};
+    prevX=x, prevY=y;
     originalX=x;
     originalY=y;
 }
 
 void PushableBlock::update(std::vector<Block> &platformBlocks, const SDL_FRect &playerHitbox,
                            bool moveLeft, bool moveRight, bool &dead, double deltaTime) {
+    PROFILE_SCOPE(ZONE_PUSHABLES);
 
     checkPush(platformBlocks, playerHitbox, moveLeft, moveRight, deltaTime);
     applyPhysics(platformBlocks, deltaTime);
@@ -733,8 +550,11 @@ void PushableBlock::applyPhysics(std::vector<Block> &platformBlocks, double delt
     nextPos.y+=velY*deltaTime;
     grounded=false;
 
-    for (const auto &block : platformBlocks) {
-        if (block.getType()!="1J" && block.getType()!="1JL" && block.getType()!="1JR") { // Ignore jump-through platforms
+    static std::vector<size_t> nearbyBlocks;
+    findNearbyBlocks(platformBlocks, hitbox.x, std::min(hitbox.y, nextPos.y), hitbox.x+hitbox.w, std::max(hitbox.y, nextPos.y)+hitbox.h, nearbyBlocks);
+    for (size_t i : nearbyBlocks) {
+        const Block &block=platformBlocks[i];
+        if (!block.hasFlag(FLAG_JUMP_THROUGH)) { // Ignore jump-through platforms
             SDL_FRect b=block.getHitbox();
             if (hitbox.y+hitbox.h<=b.y &&
                 nextPos.y+hitbox.h>=b.y &&
@@ -803,8 +623,11 @@ void PushableBlock::checkPush(std::vector<Block> &platformBlocks, const SDL_FRec
     SDL_FRect nextPos=hitbox;
     nextPos.x+=moveStep;
 
-    for (const auto &block : platformBlocks) {
-        if (block.getType()!="1J" && block.getType()!="1JL" && block.getType()!="1JR") { // Ignore jump-through platforms
+    static std::vector<size_t> nearbyBlocks;
+    findNearbyBlocks(platformBlocks, std::min(hitbox.x, nextPos.x), hitbox.y, std::max(hitbox.x, nextPos.x)+hitbox.w, hitbox.y+hitbox.h, nearbyBlocks);
+    for (size_t i : nearbyBlocks) {
+        const Block &block=platformBlocks[i];
+        if (!block.hasFlag(FLAG_JUMP_THROUGH)) { // Ignore jump-through platforms
             SDL_FRect b=block.getHitbox();
             if (hitbox.x+hitbox.w<=b.x &&
                 nextPos.x+hitbox.w>=b.x &&
@@ -837,6 +660,14 @@ void PushableBlock::resetPosition() {
     hitbox.y=originalY;
 }
 
+void PushableBlock::savePosition() {
+    prevX=hitbox.x;
+    prevY=hitbox.y;
+}
+SDL_FRect PushableBlock::getRenderHitbox(double alpha) const {
+    return interpolateHitbox(hitbox, prevX, prevY, alpha);
+}
+
 SDL_FRect PushableBlock::getHitbox() const {
     return hitbox;
 }
@@ -845,8 +676,10 @@ SDL_FRect PushableBlock::getHitbox() const {
 
 /// Spike functions start
 
-Spike::Spike(float x, float y, float w, float h, double a, SDL_RendererFlip m, const std::string &type) {
+Spike::Spike(float x, float y, float w, float h, double a, SDL_RendererFlip m, TileType type) {
     hitbox={x, y, w, h};
+    prevX=x, prevY=y;
+    mover.targetX=x, mover.targetY=y;
     angle=a;
     mirror=m;
     spikeType=type;
@@ -862,26 +695,27 @@ bool Spike::checkCollision(double playerX, double playerY, int PLAYER_WIDTH, int
 const SDL_FRect &Spike::getHitbox() const {
     return hitbox;
 }
-const std::string &Spike::getType() const {
+TileType Spike::getType() const {
     return spikeType;
 }
-void Spike::movingSpike(double deltaTime) {
-    if (unlocked) {
-        hitbox.x=realX;
-        float dy=realY-hitbox.y;
-        float distance=fabs(dy);
-        if (distance<1.0f) {
-            hitbox.y=realY;
-            unlocked=false;
-        }
-        else {
-            float moveStep=speed*deltaTime;
-            hitbox.y+=dy/distance*moveStep;
-        }
+bool Spike::updateMover(double deltaTime) {
+    markSurfaceChanged(*this);
+    if (!dynamic) {
+        dynamic=true;
+        staticRevision++;
     }
+    return mover.step(hitbox, deltaTime);
+}
+
+void Spike::savePosition() {
+    prevX=hitbox.x;
+    prevY=hitbox.y;
+}
+SDL_FRect Spike::getRenderHitbox(double alpha) const {
+    return interpolateHitbox(hitbox, prevX, prevY, alpha);
 }
-void Spike::changeSpeed(float change) {
-    speed*=change;
+bool Spike::isDynamic() const {
+    return dynamic;
 }
 
 /// Spike functions end
@@ -908,7 +742,7 @@ const char JumpOrb::getType() const {
     return orbType;
 }
 
-void JumpOrb::updateRotation(double deltaTime) const {
+void JumpOrb::updateRotation(double deltaTime) {
     rotationAngle+=180*deltaTime;
     if (rotationAngle>=360) rotationAngle-=360;
 }
@@ -917,7 +751,7 @@ void JumpOrb::updateRotation(double deltaTime) const {
 
 /// Jump pad functions start
 
-JumpPad::JumpPad(float x, float y, float w, float h, double a, const std::string &type) {
+JumpPad::JumpPad(float x, float y, float w, float h, double a, TileType type) {
     hitbox={x, y, w, h};
     angle=a;
     padType=type;
@@ -934,7 +768,7 @@ const SDL_FRect &JumpPad::getHitbox() const {
     return hitbox;
 }
 
-const std::string &JumpPad::getType() const {
+TileType JumpPad::getType() const {
     return padType;
 }
 
@@ -3,7 +3,13 @@
 #include <iostream>
 #include <SDL.h>
 #include <vector>
+#include <random>
 #include "Enums.h"
+#include "TileTypes.h"
+#include "Mover.h"
+#include "TicTacToe.h"
+#include "Enigma.h"
+#include "Economy.h"
 
 extern const float TILE_SIZE;
 
@@ -12,16 +18,30 @@ class PushableBlock;
 class Spike;
 class JumpOrb;
 class JumpPad;
+class Player;
+class LevelBehavior;
 
+extern std::mt19937 levelRandom;
 extern bool uniqueDigitsInPassword;
-extern bool botWins;
-extern bool playerWins;
-extern bool stalemate;
+
+// Passwords the Enigma checks so far still allow, the next best guess is shown when hints are on (--enigma-hints on)
+extern EnigmaSolver enigmaSolver;
+extern bool enigmaHints;
+
+// Game on the tic tac toe level, its cell blocks are redrawn from it after every move
+extern TicTacToe ticTacToe;
+
+// Bumped whenever a block or spike that never changed before changes (type or position),
+// the static layer of the renderer is redrawn when it moves
+extern unsigned int staticRevision;
+
+// Forget the puzzle state of the last attempt (Enigma password, tic tac toe outcome)
+void resetPuzzleState();
 
 class Block {
 public:
     // Constructor
-    Block(float x, float y, float w, float h, double a, SDL_RendererFlip m, const std::string &type);
+    Block(float x, float y, float w, float h, double a, SDL_RendererFlip m, TileType type);
 
     // Collision detection
     bool checkXCollision(double &playerX, double playerY, double &nextPlayerX,
@@ -35,24 +55,30 @@ public:
     const SDL_FRect &getHitbox() const;
 
     // Get + change block type
-    const std::string &getType() const;
-    void switchType(std::string newType);
+    TileType getType() const;
+    void switchType(TileType newType);
+
+    // Check a property of the block type (TileFlag)
+    bool hasFlag(uint32_t flag) const;
 
-    // Functions to change block's position
-    void movingBlockX(double deltaTime);
-    void movingBlockY(double deltaTime);
-    void changeSpeed(float change);
+    // Functions to change block's position, updateMover is true once the block arrived
+    bool updateMover(double deltaTime);
     void offsetPosition(float offsetX, float offsetY);
 
-    // Interactable blocks
+    // Position at the start of a tick, rendering interpolates from there
+    void savePosition();
+    SDL_FRect getRenderHitbox(double alpha) const;
+
+    // Check if the block can change (interactable) or has changed since it was loaded, otherwise it is drawn once per level
+    bool isDynamic() const;
+
+    // Interactable blocks, menu buttons are handled here and everything else by the level's behavior
     bool isInteractable() const;
-    void interact(unsigned long long &totalMoney, int &gainPerHit, int &passiveIncome, GameStatus &currentStatus,
-                  std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-                  const std::string &levelName, double deltaTime, bool &timeStopped, double &timeStopTimer, int &powerPercent, bool &cutscenePlaying);
+    void interact(Player &cube, GameStatus &currentStatus, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, LevelBehavior &behavior, double deltaTime);
 
-    // Helper functions for each level
-    void interactClicker(unsigned long long &totalMoney, int &gainPerHit, int &passiveIncome,
-                         std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime);
+    // Helper functions for each level, called by its LevelBehavior
+    void interactClicker(Economy &economy, std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime);
     void interactEnigma(std::vector<Block> &blocks, std::vector<Spike> &spikes);
     void interactMoveToDie(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, bool &timeStopped, double &timeStopTimer);
     void interactFiveNights(std::vector<Block> &blocks, int &powerPercent);
@@ -63,19 +89,20 @@ public:
     double angle;
     SDL_RendererFlip mirror;
 
-    // For moving blocks
-    bool unlocked=false;
-    float realX, realY;
-    float speed=300.0f;
+    // For moving blocks, TILE_1Y travels horizontally
+    Mover mover;
 
     // Internal values
     int counter=0;
-    int value=5;
-    int increment=5;
 
 private:
     SDL_FRect hitbox;
-    std::string blockType;
+    float prevX, prevY;
+    TileType blockType;
+    uint32_t flags; // tileInfo[blockType].flags
+    bool dynamic;
+
+    void markDynamic();
 };
 
 class PushableBlock {
@@ -95,6 +122,10 @@ public:
     // Reset position
     void resetPosition();
 
+    // Position at the start of a tick, rendering interpolates from there
+    void savePosition();
+    SDL_FRect getRenderHitbox(double alpha) const;
+
     // Get block hitbox
     SDL_FRect getHitbox() const;
 
@@ -109,7 +140,7 @@ public:
     double TERMINAL_VELOCITY=5000.0;
     double PUSH_SPEED=300.0;
     bool grounded=false;
-    bool touchingLeft, touchingRight;
+    bool touchingLeft=false, touchingRight=false;
 
     // For time stop level
     bool resetQueued=false;
@@ -119,30 +150,38 @@ public:
 
 private:
     SDL_FRect hitbox;
+    float prevX, prevY;
 };
 
 class Spike {
 public:
-    Spike(float x, float y, float w, float h, double a, SDL_RendererFlip m, const std::string &type);
+    Spike(float x, float y, float w, float h, double a, SDL_RendererFlip m, TileType type);
 
     bool checkCollision(double playerX, double playerY, int PLAYER_WIDTH, int PLAYER_HEIGHT) const;
 
     const SDL_FRect &getHitbox() const;
-    const std::string &getType() const;
+    TileType getType() const;
+
+    // Move toward the mover's target, true once the spike arrived
+    bool updateMover(double deltaTime);
+
+    // Position at the start of a tick, rendering interpolates from there
+    void savePosition();
+    SDL_FRect getRenderHitbox(double alpha) const;
 
-    void movingSpike(double deltaTime);
-    void changeSpeed(float change);
+    // Check if the spike has moved since it was loaded
+    bool isDynamic() const;
 
     double angle;
     SDL_RendererFlip mirror;
 
-    bool unlocked=false;
-    float realX, realY;
-    float speed=300.0f;
+    Mover mover;
 
 private:
     SDL_FRect hitbox;
-    std::string spikeType;
+    float prevX, prevY;
+    TileType spikeType;
+    bool dynamic=false;
 };
 
 class JumpOrb {
@@ -155,8 +194,8 @@ public:
 
     const char getType() const;
 
-    mutable double rotationAngle=0.0;
-    void updateRotation(double deltaTime) const;
+    double rotationAngle=0.0;
+    void updateRotation(double deltaTime);
 
 private:
     SDL_FRect hitbox;
@@ -165,12 +204,12 @@ private:
 
 class JumpPad {
 public:
-    JumpPad(float x, float y, float w, float h, double a, const std::string &type);
+    JumpPad(float x, float y, float w, float h, double a, TileType type);
 
     bool checkCollision(double playerX, double playerY, int PLAYER_WIDTH, int PLAYER_HEIGHT) const;
 
     const SDL_FRect &getHitbox() const;
-    const std::string &getType() const;
+    TileType getType() const;
 
     // Only trigger pad once
     void markUsed();
@@ -181,6 +220,6 @@ public:
 
 private:
     SDL_FRect hitbox;
-    std::string padType;
+    TileType padType;
     bool padUsed=false;
 };
@@ -3,14 +3,22 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <sys/stat.h>
+#include <SDL.h>
 #include "LevelObjs.h"
 #include "LoadLevel.h"
+#include "LevelFormat.h"
+#include "Profiler.h"
 
 // Split the level into tiles to place objects
 const float TILE_SIZE=SCREEN_HEIGHT/10.0f;
 const int LEVEL_WIDTH=19;
 const int LEVEL_HEIGHT=11;
 
+// Level files are either the text grid or the compiled binary made by the level compiler
+const std::string LEVEL_TEXT_EXTENSION=".txt";
+const std::string LEVEL_COMPILED_EXTENSION=".dtwl";
+
 // Vector to store objects
 std::vector<Block> blocks;
 std::vector<Spike> spikes;
@@ -18,126 +26,7 @@ std::vector<JumpOrb> jumpOrbs;
 std::vector<JumpPad> jumpPads;
 std::vector<PushableBlock> pushableBlocks;
 
-// Identify block type
-std::unordered_map<std::string, BlockInfo> blockLookup={
-    {"1C0", {0, 0, SDL_FLIP_NONE}},     // Top left level corner
-    {"1C1", {0, 90, SDL_FLIP_NONE}},    // Top right level corner
-    {"1C2", {0, 180, SDL_FLIP_NONE}},   // Bottom right level corner
-    {"1C3", {0, 270, SDL_FLIP_NONE}},   // Bottom left level corner
-
-    {"1WH", {1, 0, SDL_FLIP_NONE}},     // Horizontal wall
-    {"1WV", {1, 90, SDL_FLIP_NONE}},    // Vertical wall
-    {"1WVI", {1, 90, SDL_FLIP_NONE}},   // Vertical wall (interactable)
-
-    {"1TL", {2, 0, SDL_FLIP_NONE}},     // T-block left
-    {"1TU", {2, 90, SDL_FLIP_NONE}},    // T-block up
-    {"1TR", {2, 180, SDL_FLIP_NONE}},   // T-block right
-    {"1TD", {2, 270, SDL_FLIP_NONE}},   // T-block down
-
-    {"1PU", {3, 0, SDL_FLIP_NONE}},     // Platform tip up
-    {"1PR", {3, 90, SDL_FLIP_NONE}},    // Platform tip right
-    {"1PD", {3, 180, SDL_FLIP_NONE}},   // Platform tip down
-    {"1PL", {3, 270, SDL_FLIP_NONE}},   // Platform tip left
-
-    {"1E", {4, 0, SDL_FLIP_NONE}},      // No border block
-    {"1B", {5, 0, SDL_FLIP_NONE}},      // All border block
-    {"1BI", {5, 0, SDL_FLIP_NONE}},     // All border block (interactable)
-    {"1BG", {5, 0, SDL_FLIP_NONE}},     // All border block (green)
-    {"1BO", {5, 0, SDL_FLIP_NONE}},     // All border block (orange)
-    {"1BY", {5, 0, SDL_FLIP_NONE}},     // All border block (dio)
-
-    {"1I1", {6, 0, SDL_FLIP_NONE}},     // Idle tycoon block 1 - misc upgrade
-    {"1I2", {7, 0, SDL_FLIP_NONE}},     // Idle tycoon block 2 - lower the point block
-    {"1I3", {8, 0, SDL_FLIP_NONE}},     // Idle tycoon block 3 - point upgrade
-    {"1I4", {9, 0, SDL_FLIP_NONE}},     // Idle tycoon block 4 - passive income upgrade
-    {"1IP", {10, 0, SDL_FLIP_NONE}},    // Idle tycoon - point block
-
-    {"1S", {11, 0, SDL_FLIP_NONE}},     // Menu block 1 - settings
-    {"1P", {12, 0, SDL_FLIP_NONE}},     // Menu block 2 - start
-    {"1C", {13, 0, SDL_FLIP_NONE}},     // Menu block 3 - credits
-
-    {"1IN", {14, 0, SDL_FLIP_NONE}},    // Password puzzle - check solution
-    {"1BB", {15, 0, SDL_FLIP_NONE}},    // Pool puzzle - add water
-    {"1SA", {16, 0, SDL_FLIP_NONE}},    // Time puzzle - stop time
-    {"1MV", {17, 0, SDL_FLIP_NONE}},    // Pushable block
-
-    {"1XM", {18, 0, SDL_FLIP_NONE}},    // Tic-tac-toe puzzle - move X to next position
-    {"1XI", {19, 0, SDL_FLIP_NONE}},    // Tic-tac-toe puzzle - X block (interactable)
-    {"1X", {19, 0, SDL_FLIP_NONE}},     // Tic-tac-toe puzzle - X block
-    {"1O", {20, 0, SDL_FLIP_NONE}},     // Tic-tac-toe puzzle - O block
-    {"1R", {21, 0, SDL_FLIP_NONE}},     // Reset puzzle
-
-    {"1ZA", {22, 0, SDL_FLIP_NONE}},    // Electricity puzzle - deplete
-
-    {"1K0", {23, 0, SDL_FLIP_NONE}},    // Top left corner block
-    {"1K1", {23, 90, SDL_FLIP_NONE}},   // Top right corner block
-    {"1K2", {23, 180, SDL_FLIP_NONE}},  // Bottom right corner block
-    {"1K3", {23, 270, SDL_FLIP_NONE}},  // Bottom left corner block
-
-    {"1LU", {24, 0, SDL_FLIP_NONE}},    // Line block up
-    {"1LR", {24, 90, SDL_FLIP_NONE}},   // Line block right
-    {"1LD", {24, 180, SDL_FLIP_NONE}},  // Line block down
-    {"1LL", {24, 270, SDL_FLIP_NONE}},  // Line block left
-
-    {"1JL", {28, 0, SDL_FLIP_NONE}},        // Jump-through platform attached to left wall
-    {"1JR", {28, 0, SDL_FLIP_HORIZONTAL}},  // Jump-through platform attached to right wall
-    {"1J", {29, 0, SDL_FLIP_NONE}},         // Jump-through platform in the air
-
-    {"1Y", {30, 0, SDL_FLIP_NONE}},     // Invisible block
-
-/***********************************************************************************************/
-
-    // Platform tip[25] with spike
-    {"3AU", {25, 0, SDL_FLIP_NONE}},    // Facing up
-    {"3AR", {25, 90, SDL_FLIP_NONE}},   // Facing right
-    {"3AD", {25, 180, SDL_FLIP_NONE}},  // Facing down
-    {"3AL", {25, 270, SDL_FLIP_NONE}},  // Facing left
-
-    // Platform tip[25] with spike, mirrored
-    {"3AUM", {25, 0, SDL_FLIP_HORIZONTAL}},     // Facing up
-    {"3ARM", {25, 90, SDL_FLIP_HORIZONTAL}},    // Facing right
-    {"3ADM", {25, 180, SDL_FLIP_HORIZONTAL}},   // Facing down
-    {"3ALM", {25, 270, SDL_FLIP_HORIZONTAL}},   // Facing left
-
-    // Normal platform[26] with spike
-    {"3CU", {26, 0, SDL_FLIP_NONE}},    // Facing up
-    {"3CR", {26, 90, SDL_FLIP_NONE}},   // Facing right
-    {"3CD", {26, 180, SDL_FLIP_NONE}},  // Facing down
-    {"3CL", {26, 270, SDL_FLIP_NONE}},  // Facing left
-
-    // Normal platform[27] with big spike
-    {"3EU", {27, 0, SDL_FLIP_NONE}},    // Facing up
-    {"3ER", {27, 90, SDL_FLIP_NONE}},   // Facing right
-    {"3ED", {27, 180, SDL_FLIP_NONE}},  // Facing down
-    {"3EL", {27, 270, SDL_FLIP_NONE}}   // Facing left
-};
-
-// Identify spike type
-std::unordered_map<std::string, SpikeInfo> spikeLookup={ // Note: Spike platform migrated to blocks (number 3 in front)
-    // Platform tip with spike[0]
-    {"2AU", {0, 0, SDL_FLIP_NONE}},     // Facing up
-    {"2AR", {0, 90, SDL_FLIP_NONE}},    // Facing right
-    {"2AD", {0, 180, SDL_FLIP_NONE}},   // Facing down
-    {"2AL", {0, 270, SDL_FLIP_NONE}},   // Facing left
-
-    // Platform tip with spike[0], mirrored
-    {"2AUM", {0, 0, SDL_FLIP_HORIZONTAL}},      // Facing up
-    {"2ARM", {0, 90, SDL_FLIP_HORIZONTAL}},     // Facing right
-    {"2ADM", {0, 180, SDL_FLIP_HORIZONTAL}},    // Facing down
-    {"2ALM", {0, 270, SDL_FLIP_HORIZONTAL}},    // Facing left
-
-    // Normal platform with spike[1]
-    {"2CU", {1, 0, SDL_FLIP_NONE}},     // Facing up
-    {"2CR", {1, 90, SDL_FLIP_NONE}},    // Facing right
-    {"2CD", {1, 180, SDL_FLIP_NONE}},   // Facing down
-    {"2CL", {1, 270, SDL_FLIP_NONE}},   // Facing left
-
-    // Normal platform with big spike[2]
-    {"2EU", {2, 0, SDL_FLIP_NONE}},     // Facing up
-    {"2ER", {2, 90, SDL_FLIP_NONE}},    // Facing right
-    {"2ED", {2, 180, SDL_FLIP_NONE}},   // Facing down
-    {"2EL", {2, 270, SDL_FLIP_NONE}},    // Facing left
-};
+unsigned int levelRevision=0;
 
 // Identify jump orb type
 std::unordered_map<std::string, JumpOrbInfo> jumpOrbLookup={
@@ -166,27 +55,46 @@ std::unordered_map<std::string, JumpOrbInfo> jumpOrbLookup={
     {"DXY", {3, TILE_SIZE/2, TILE_SIZE/2}},
 };
 
-// Identify jump pad type
-std::unordered_map<std::string, JumpPadInfo> jumpPadLookup={
-    {"JU", {0, 0}},      // Yellow pad up
-    {"JD", {0, 180}},    // Yellow pad down
+// Level file paths already looked up, keyed by level name
+static std::unordered_map<std::string, std::string> resolvedPaths;
+
+// Look on disk for the file of a level, touches no shared state so the prefetch thread can use it
+// A compiled level older than its text file is stale (the level was edited since), the text file wins then
+static std::string findLevelFile(const std::string &name) {
+    std::string compiledPath="Resources/Levels/"+name+LEVEL_COMPILED_EXTENSION;
+    std::string textPath="Resources/Levels/"+name+LEVEL_TEXT_EXTENSION;
+    struct stat compiled, text;
+    if (stat(compiledPath.c_str(), &compiled)!=0) return textPath;
+    if (stat(textPath.c_str(), &text)==0 && text.st_mtime>compiled.st_mtime) {
+        std::cout << "Compiled level is older than " << textPath << ", loading the text file." << std::endl;
+        return textPath;
+    }
+    return compiledPath;
+}
 
-    {"SU", {1, 0}},      // Spider pad up
-    {"SR", {1, 90}},     // Spider pad right
-    {"SD", {1, 180}},    // Spider pad down
-    {"SL", {1, 270}},    // Spider pad left
+// Path of a level file, the compiled version is used when it exists
+std::string levelPath(const std::string &name) {
+    auto it=resolvedPaths.find(name);
+    if (it!=resolvedPaths.end()) return it->second;
 
-    {"PU", {2, 0}},      // Pink pad up
-    {"PD", {2, 180}},    // Pink pad down
-};
+    std::string path=findLevelFile(name);
+    resolvedPaths[name]=path;
+    return path;
+}
 
-// Load level from a file
-void loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
-               std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads) {
-    std::ifstream file(path);
+// Read a level file into the vectors, safe off the main thread
+static bool parseLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                       std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads) {
+    PROFILE_SPAN_DETAIL("loadLevel", path.c_str());
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         std::cout << "Failed to open level file." << std::endl;
-        return;
+        return false;
+    }
+
+    // Compiled levels are a straight copy, no parsing needed
+    if (isCompiledLevel(file)) {
+        return loadCompiledLevel(file, blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
     }
 
     blocks.clear(); pushableBlocks.clear(); spikes.clear(); jumpOrbs.clear(); jumpPads.clear();
@@ -200,72 +108,71 @@ void loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<
             float baseY=row*TILE_SIZE-TILE_SIZE*9/18;
 
             file >> tile;
+            TileType type=findTileType(tile);
+            const TileInfo &info=tileInfo[type];
 
             // Store blocks
-            if (blockLookup.find(tile)!=blockLookup.end()) {
-                BlockInfo info=blockLookup[tile];
-                if (tile!="1MV") blocks.emplace_back(baseX, baseY, TILE_SIZE, TILE_SIZE, info.rotation, info.mirrored, tile);
+            if (info.flags&FLAG_BLOCK) {
+                if (type!=TILE_1MV) blocks.emplace_back(baseX, baseY, TILE_SIZE, TILE_SIZE, info.rotation, info.mirrored, type);
                 else pushableBlocks.emplace_back(baseX, baseY, TILE_SIZE, TILE_SIZE);
             }
 
             // Store spikes
-            else if (spikeLookup.find(tile)!=spikeLookup.end()) {
-                SpikeInfo info=spikeLookup[tile];
-                if (tile[1]=='A' || tile[1]=='C') { // Small spike
+            else if (info.flags&FLAG_SPIKE) {
+                if (!(info.flags&FLAG_BIG_SPIKE)) { // Small spike
                     if (info.rotation==0) {
-                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE*7/10, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE*7/10, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, type);
                     }
                     else if (info.rotation==90) {
-                        spikes.emplace_back(baseX+TILE_SIZE/10, baseY+TILE_SIZE*2/5, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE/10, baseY+TILE_SIZE*2/5, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, type);
                     }
                     else if (info.rotation==180) {
-                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE/10, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, type);
                     }
                     else if (info.rotation==270) {
-                        spikes.emplace_back(baseX+TILE_SIZE*7/10, baseY+TILE_SIZE*2/5, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE*7/10, baseY+TILE_SIZE*2/5, TILE_SIZE/5, TILE_SIZE/5, info.rotation, info.mirrored, type);
                     }
                 }
-                else if (tile[1]=='E') { // Big spike
+                else { // Big spike
                     if (info.rotation==0 || info.rotation==180) {
-                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE*3/10, TILE_SIZE/5, TILE_SIZE*2/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE*2/5, baseY+TILE_SIZE*3/10, TILE_SIZE/5, TILE_SIZE*2/5, info.rotation, info.mirrored, type);
                     }
                     else if (info.rotation==90 || info.rotation==270) {
-                        spikes.emplace_back(baseX+TILE_SIZE*3/10, baseY+TILE_SIZE*2/5, TILE_SIZE*2/5, TILE_SIZE/5, info.rotation, info.mirrored, tile);
+                        spikes.emplace_back(baseX+TILE_SIZE*3/10, baseY+TILE_SIZE*2/5, TILE_SIZE*2/5, TILE_SIZE/5, info.rotation, info.mirrored, type);
                     }
                 }
             }
 
             // Store jump pads
-            else if (jumpPadLookup.find(tile)!=jumpPadLookup.end()) {
-                JumpPadInfo info=jumpPadLookup[tile];
-                if (tile[0]=='J' || tile[0]=='P') {
+            else if (info.flags&FLAG_PAD) {
+                if (!(info.flags&FLAG_SPIDER_PAD)) {
                     if (info.rotation==0) {
-                        jumpPads.emplace_back(baseX+TILE_SIZE/12, baseY+TILE_SIZE*13/15, TILE_SIZE*10/12, TILE_SIZE/6, info.rotation, tile);
+                        jumpPads.emplace_back(baseX+TILE_SIZE/12, baseY+TILE_SIZE*13/15, TILE_SIZE*10/12, TILE_SIZE/6, info.rotation, type);
                     }
                     else if (info.rotation==180) {
-                        jumpPads.emplace_back(baseX+TILE_SIZE/12, baseY-TILE_SIZE/30, TILE_SIZE*10/12, TILE_SIZE/6, info.rotation, tile);
+                        jumpPads.emplace_back(baseX+TILE_SIZE/12, baseY-TILE_SIZE/30, TILE_SIZE*10/12, TILE_SIZE/6, info.rotation, type);
                     }
                 }
-                else if (tile[0]=='S') { // Spider pad
+                else { // Spider pad
                     if (info.rotation==0) {
-                        jumpPads.emplace_back(baseX+TILE_SIZE/30, baseY+TILE_SIZE*3/4, TILE_SIZE*14/15, TILE_SIZE*2/5, info.rotation, tile);
+                        jumpPads.emplace_back(baseX+TILE_SIZE/30, baseY+TILE_SIZE*3/4, TILE_SIZE*14/15, TILE_SIZE*2/5, info.rotation, type);
                     }
                     else if (info.rotation==90) {
-                        jumpPads.emplace_back(baseX-TILE_SIZE*3/20, baseY+TILE_SIZE/30, TILE_SIZE*2/5, TILE_SIZE*14/15, info.rotation, tile);
+                        jumpPads.emplace_back(baseX-TILE_SIZE*3/20, baseY+TILE_SIZE/30, TILE_SIZE*2/5, TILE_SIZE*14/15, info.rotation, type);
                     }
                     else if (info.rotation==180) {
-                        jumpPads.emplace_back(baseX+TILE_SIZE/30, baseY-TILE_SIZE*3/20, TILE_SIZE*14/15, TILE_SIZE*2/5, info.rotation, tile);
+                        jumpPads.emplace_back(baseX+TILE_SIZE/30, baseY-TILE_SIZE*3/20, TILE_SIZE*14/15, TILE_SIZE*2/5, info.rotation, type);
                     }
                     else if (info.rotation==270) {
-                        jumpPads.emplace_back(baseX+TILE_SIZE*3/4, baseY+TILE_SIZE/30, TILE_SIZE*2/5, TILE_SIZE*14/15, info.rotation, tile);
+                        jumpPads.emplace_back(baseX+TILE_SIZE*3/4, baseY+TILE_SIZE/30, TILE_SIZE*2/5, TILE_SIZE*14/15, info.rotation, type);
                     }
                 }
             }
 
             // Store jump orbs
-            else if (jumpOrbLookup.find(tile)!=jumpOrbLookup.end()) {
-                JumpOrbInfo info=jumpOrbLookup[tile];
-                jumpOrbs.emplace_back(baseX-TILE_SIZE/10+info.offsetX, baseY-TILE_SIZE/10+info.offsetY, TILE_SIZE*12/10, TILE_SIZE*12/10, tile[0]);
+            else if (jumpOrbLookup.count(tile)) {
+                const JumpOrbInfo &orbInfo=jumpOrbLookup.at(tile);
+                jumpOrbs.emplace_back(baseX-TILE_SIZE/10+orbInfo.offsetX, baseY-TILE_SIZE/10+orbInfo.offsetY, TILE_SIZE*12/10, TILE_SIZE*12/10, tile[0]);
             }
         }
 
@@ -273,4 +180,112 @@ void loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<
     }
 
     file.close();
+    return true;
+}
+
+// Load level from a file, text or compiled
+bool loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+               std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads) {
+    levelRevision++;
+    return parseLevel(path, blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
+}
+
+// Parsed levels, keyed by file path
+static std::unordered_map<std::string, LevelData> levelCache;
+
+// Level being parsed in the background, at most one at a time
+struct LevelPrefetch {
+    std::string name;
+    std::string path;
+    LevelData level;
+    bool loaded=false;
+    SDL_Thread *thread=nullptr;
+    SDL_atomic_t done;
+};
+static LevelPrefetch *prefetch=nullptr;
+
+static int prefetchWorker(void *data) {
+    LevelPrefetch *job=static_cast<LevelPrefetch*>(data);
+    job->path=findLevelFile(job->name);
+    job->loaded=parseLevel(job->path, job->level.blocks, job->level.pushableBlocks, job->level.spikes,
+                           job->level.jumpOrbs, job->level.jumpPads);
+    SDL_AtomicSet(&job->done, 1);
+    return 0;
+}
+
+// Wait for the prefetch thread and move what it parsed into the cache
+static void finishPrefetch() {
+    if (prefetch==nullptr) return;
+    SDL_WaitThread(prefetch->thread, nullptr);
+    resolvedPaths[prefetch->name]=prefetch->path;
+    if (prefetch->loaded) levelCache.emplace(prefetch->path, std::move(prefetch->level));
+    delete prefetch;
+    prefetch=nullptr;
+}
+
+// Check if a path is one of the files the level could be in
+static bool isLevelFile(const std::string &path, const std::string &name) {
+    return path=="Resources/Levels/"+name+LEVEL_COMPILED_EXTENSION || path=="Resources/Levels/"+name+LEVEL_TEXT_EXTENSION;
+}
+
+void prefetchLevel(const std::string &name) {
+    if (prefetch!=nullptr) {
+        if (prefetch->name==name || !SDL_AtomicGet(&prefetch->done)) return; // Never block here, the new request just loads on demand
+        finishPrefetch();
+    }
+    auto path=resolvedPaths.find(name);
+    if (path!=resolvedPaths.end() && levelCache.count(path->second)) return;
+
+    prefetch=new LevelPrefetch;
+    prefetch->name=name;
+    SDL_AtomicSet(&prefetch->done, 0);
+    prefetch->thread=SDL_CreateThread(prefetchWorker, "LevelPrefetch", prefetch);
+    if (prefetch->thread==nullptr) {
+        delete prefetch; // The level gets loaded when it's started instead
+        prefetch=nullptr;
+    }
+}
+
+bool levelReady(const std::string &name) {
+    if (prefetch==nullptr || prefetch->name!=name) return true;
+    if (!SDL_AtomicGet(&prefetch->done)) return false;
+    finishPrefetch();
+    return true;
+}
+
+// Get the pristine copy of a level, parsing the file only the first time
+const LevelData *getCachedLevel(const std::string &path) {
+    // A level still being prefetched is waited for rather than parsed twice
+    if (prefetch!=nullptr && (SDL_AtomicGet(&prefetch->done) || isLevelFile(path, prefetch->name))) finishPrefetch();
+
+    auto it=levelCache.find(path);
+    if (it!=levelCache.end()) return &it->second;
+
+    LevelData level;
+    if (!parseLevel(path, level.blocks, level.pushableBlocks, level.spikes, level.jumpOrbs, level.jumpPads)) {
+        return nullptr; // Don't cache failures, the file may show up later
+    }
+    return &levelCache.emplace(path, std::move(level)).first->second;
+}
+
+// Copy a cached level into the working vectors
+bool restoreLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads) {
+    const LevelData *level=getCachedLevel(path);
+    if (level==nullptr) return false;
+
+    // Copy assignment keeps the vectors' capacity, so this doesn't allocate after the first time
+    blocks=level->blocks;
+    pushableBlocks=level->pushableBlocks;
+    spikes=level->spikes;
+    jumpOrbs=level->jumpOrbs;
+    jumpPads=level->jumpPads;
+    levelRevision++;
+    return true;
+}
+
+// Forget every parsed level
+void clearLevelCache() {
+    finishPrefetch();
+    levelCache.clear();
 }
@@ -13,6 +13,14 @@ extern const float TILE_SIZE;
 extern const int LEVEL_WIDTH;
 extern const int LEVEL_HEIGHT;
 
+// Every level in play order, level file names match these
+extern const int ALL_LEVELS;
+extern std::string levelName[];
+
+// Level files are either the text grid or the compiled binary made by the level compiler
+extern const std::string LEVEL_TEXT_EXTENSION;
+extern const std::string LEVEL_COMPILED_EXTENSION;
+
 // Vector to store objects
 extern std::vector<Block> blocks;
 extern std::vector<Spike> spikes;
@@ -20,22 +28,6 @@ extern std::vector<JumpOrb> jumpOrbs;
 extern std::vector<JumpPad> jumpPads;
 extern std::vector<PushableBlock> pushableBlocks;
 
-// Identify block type
-struct BlockInfo {
-    int clipIndex;
-    double rotation;
-    SDL_RendererFlip mirrored;
-};
-extern std::unordered_map<std::string, BlockInfo> blockLookup;
-
-// Identify spike type
-struct SpikeInfo {
-    int clipIndex;
-    double rotation;
-    SDL_RendererFlip mirrored;
-};
-extern std::unordered_map<std::string, SpikeInfo> spikeLookup;
-
 // Identify jump orb type
 struct JumpOrbInfo {
     int clipIndex;
@@ -44,14 +36,39 @@ struct JumpOrbInfo {
 };
 extern std::unordered_map<std::string, JumpOrbInfo> jumpOrbLookup;
 
-// Identify jump pad type
-struct JumpPadInfo {
-    int clipIndex;
-    double rotation;
-};
-extern std::unordered_map<std::string, JumpPadInfo> jumpPadLookup;
+// Bumped every time a level is loaded into a set of vectors, lets derived data (block grid) know it is stale
+extern unsigned int levelRevision;
+
+// Path of a level file, the compiled version is used when it exists
+std::string levelPath(const std::string &name);
 
-// Load level from a file
-void loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+// Load level from a file, text or compiled
+bool loadLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
                std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads);
 
+// Parsed level, kept untouched so it can be handed out again without reading the file
+struct LevelData {
+    std::vector<Block> blocks;
+    std::vector<PushableBlock> pushableBlocks;
+    std::vector<Spike> spikes;
+    std::vector<JumpOrb> jumpOrbs;
+    std::vector<JumpPad> jumpPads;
+};
+
+// Get the pristine copy of a level, parsing the file only the first time (nullptr if it can't be loaded)
+const LevelData *getCachedLevel(const std::string &path);
+
+// Copy a cached level into the working vectors, no file access after the first load
+bool restoreLevel(const std::string &path, std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks,
+                  std::vector<Spike> &spikes, std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads);
+
+// Parse a level on a background thread so starting it later costs no file access
+// Only one level is prefetched at a time, other requests meanwhile are dropped
+void prefetchLevel(const std::string &name);
+
+// False while the level is still being prefetched, it's in the cache once this returns true
+bool levelReady(const std::string &name);
+
+// Forget every parsed level, waits for a prefetch in progress
+void clearLevelCache();
+
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <vector>
+#include <SDL.h>
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "Hitboxes.h"
+#include "Mover.h"
+
+bool Mover::step(SDL_FRect &hitbox, double deltaTime) const {
+    float &position=(horizontal ? hitbox.x : hitbox.y);
+    float target=(horizontal ? targetX : targetY);
+    if (horizontal) hitbox.y=targetY;
+    else hitbox.x=targetX;
+
+    float delta=target-position;
+    float distance=fabs(delta);
+    if (distance<1.0f) {
+        position=target;
+        return true;
+    }
+    float moveStep=speed*deltaTime;
+    if (easing==EASE_OUT && distance<TILE_SIZE) moveStep*=distance/TILE_SIZE;
+    position+=delta/distance*moveStep;
+    return false;
+}
+
+// Indices of the moving objects of one vector, forgotten when a level is loaded
+struct MoverList {
+    std::vector<size_t> active;
+    std::vector<size_t> arrived;
+    const void *source=nullptr;
+    unsigned int revision=0;
+};
+
+static MoverList blockMovers;
+static MoverList spikeMovers;
+
+template <typename T>
+static void startMover(MoverList &list, std::vector<T> &objects, T &object, float x, float y, float speedScale) {
+    if (list.source!=&objects || list.revision!=levelRevision) {
+        list.active.clear();
+        list.source=&objects;
+        list.revision=levelRevision;
+    }
+    object.mover.targetX=x;
+    object.mover.targetY=y;
+    object.mover.speed*=speedScale;
+    if (object.mover.active) return;
+    object.mover.active=true;
+    list.active.push_back(&object-objects.data());
+}
+
+void startMoving(std::vector<Block> &blocks, Block &block, float x, float y, float speedScale) {
+    startMover(blockMovers, blocks, block, x, y, speedScale);
+}
+void startMoving(std::vector<Spike> &spikes, Spike &spike, float x, float y, float speedScale) {
+    startMover(spikeMovers, spikes, spike, x, y, speedScale);
+}
+
+// Step every mover of a list, compacting the list as objects arrive
+template <typename T, typename Moved>
+static void updateList(MoverList &list, std::vector<T> &objects, double deltaTime, Moved moved) {
+    if (list.source!=&objects || list.revision!=levelRevision) return;
+    size_t kept=0;
+    list.arrived.clear();
+    for (size_t i : list.active) {
+        if (i>=objects.size()) continue;
+        bool arrived=objects[i].updateMover(deltaTime);
+        moved(i);
+        if (arrived) {
+            objects[i].mover.active=false;
+            list.arrived.push_back(i);
+        }
+        else list.active[kept++]=i;
+    }
+    list.active.resize(kept);
+
+    // Callbacks last, they may start new movers
+    for (size_t i : list.arrived) {
+        if (objects[i].mover.onArrive!=nullptr) objects[i].mover.onArrive(i);
+    }
+}
+
+void updateMovers(std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime) {
+    updateList(blockMovers, blocks, deltaTime, [](size_t) {});
+    updateList(spikeMovers, spikes, deltaTime, [&spikes](size_t i) {
+        // Keep the packed spike hitboxes in step, the player is tested against them right after
+        if (spikeHitboxes.source==&spikes && i<spikeHitboxes.left.size()) setHitbox(spikeHitboxes, i, spikes[i].getHitbox());
+    });
+}
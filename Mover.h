@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <SDL.h>
+
+class Block;
+class Spike;
+
+// How a mover approaches its target
+enum MoverEasing {
+    EASE_LINEAR, // Same speed the whole way
+    EASE_OUT     // Slows down over the last tile
+};
+
+// Kinematic mover shared by blocks and spikes: travels to its target along one axis at its speed,
+// the other axis snaps to the target right away.
+// Moving objects are kept in an active list per object kind, so a tick only touches what is actually moving.
+struct Mover {
+    float targetX, targetY;
+    float speed=300.0f;
+    bool horizontal=false;
+    MoverEasing easing=EASE_LINEAR;
+
+    // In the active list, cleared once it arrives
+    bool active=false;
+
+    // Called with the object's index after it arrived, may start it moving again
+    void (*onArrive)(size_t index)=nullptr;
+
+    // Move a hitbox one tick closer to the target, true once it got there
+    bool step(SDL_FRect &hitbox, double deltaTime) const;
+};
+
+// Send an object of the level vectors toward (x, y), speedScale multiplies its speed for good
+// An object that is already moving just gets the new target
+void startMoving(std::vector<Block> &blocks, Block &block, float x, float y, float speedScale=1);
+void startMoving(std::vector<Spike> &spikes, Spike &spike, float x, float y, float speedScale=1);
+
+// Move every active block and spike one tick, objects that arrived leave the list
+void updateMovers(std::vector<Block> &blocks, std::vector<Spike> &spikes, double deltaTime);
@@ -1,17 +1,19 @@
 #include <iostream>
 #include <SDL.h>
-#include <SDL_mixer.h>
 #include <cmath>
+#include <algorithm>
 #include "Player.h"
 #include "Texture.h"
 #include "LevelObjs.h"
+#include "BlockGrid.h"
+#include "SurfaceIndex.h"
+#include "Hitboxes.h"
+#include "Audio.h"
+#include "Profiler.h"
+#include "LevelBehavior.h"
 #include "Enums.h"
 
-extern SDL_Renderer *gRenderer;
 extern LTexture cubeTexture;
-extern LTexture toBeContinued;
-extern Mix_Music *fnafSong;
-extern Mix_Music *jojoSong;
 
 // Constructor
 Player::Player() {
@@ -29,10 +31,9 @@ Player::Player() {
     touchingOrb=false;
     isDashing=false;
     coyoteTimer=0.0;
-    totalMoney=0;
-    gainPerHit=1;
-    passiveIncome=0;
-    income=0;
+    economy.reset();
+    mPrevPosX=mPosX;
+    mPrevPosY=mPosY;
 }
 
 // Reset player status
@@ -51,10 +52,18 @@ void Player::reset() {
     touchingOrb=false;
     isDashing=false;
     coyoteTimer=0.0;
-    totalMoney=0;
-    gainPerHit=1;
-    passiveIncome=0;
-    income=0;
+    economy.reset();
+    timeStopped=false;
+    timeStopTimer=0;
+    powerPercent=100;
+    drain=0;
+    powerOut=false;
+    diedFromPowerOut=false;
+    cutscenePlaying=false;
+    roundaboutPlaying=false;
+    levelFreeze=false;
+    mPrevPosX=mPosX;
+    mPrevPosY=mPosY;
 }
 void Player::resetBool() {
     isJumpHeld=false;
@@ -118,10 +127,25 @@ void Player::handleEvent(SDL_Event &e) {
     }
 }
 
+// Get the held keys, for recording replays
+bool Player::getJumpHeld() {
+    return isJumpHeld;
+}
+
+// Set the held keys directly, for input that doesn't come from SDL events
+void Player::setInput(bool left, bool right, bool jump) {
+    moveLeft=left;
+    moveRight=right;
+    isJumpHeld=jump;
+}
+
 // Allow player to enter 1-block-wide gap
 void Player::forcePushIntoGap(std::vector<Block> &blocks) {
     int limit=ceil(TILE_SIZE/double(15.0));
-    for (size_t i=0; i<blocks.size()-1; i++) {
+    // The left block of the gap has to be next to the player, the right one is the block after it
+    findNearbyBlocks(blocks, mPosX, mPosY, mPosX+PLAYER_WIDTH, mPosY+PLAYER_HEIGHT, nearbyBlocks);
+    for (size_t i : nearbyBlocks) {
+        if (i+1>=blocks.size()) continue;
         const SDL_FRect leftBlock=blocks[i].getHitbox();
         const SDL_FRect rightBlock=blocks[i+1].getHitbox();
         {
@@ -169,23 +193,20 @@ void Player::forcePushIntoGap(std::vector<Block> &blocks) {
 
 // Move player, platform physics included, deltaTime for consistent physics
 void Player::move(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-                  std::vector<JumpOrb> &jumpOrbs, GameStatus &currentStatus, const std::string &levelName, double deltaTime) {
+                  std::vector<JumpOrb> &jumpOrbs, GameStatus &currentStatus, LevelBehavior &behavior, double deltaTime) {
+    PROFILE_SCOPE(ZONE_MOVE);
 
     // If player touches both orb and platform, prioritize orb
     touchingOrb=false;
     if (!isJumpHeld || hitCeiling) isDashing=false;
 
-    for (auto &orb : jumpOrbs) {
-        if (orb.checkCollision(mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT)) {
-            touchingOrb=true;
-        }
+    syncHitboxes(jumpOrbHitboxes, jumpOrbs);
+    if (overlapHitboxes(jumpOrbHitboxes, mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT, hitMask)) {
+        touchingOrb=true;
     }
 
     // Flip input
-    if (levelName=="Vertigo") {
-        flippedInput=true;
-    }
-    else flippedInput=false;
+    flippedInput=behavior.flipsInput();
 
     // Horizontal movement
     if (!isDashing || !isJumpHeld) {
@@ -203,13 +224,13 @@ void Player::move(std::vector<Block> &blocks, std::vector<PushableBlock> &pushab
 
     double nextPosX=mPosX+mVelX*deltaTime;
 
-    // Block collision detection (X axis)
-    for (auto &block : blocks) {
+    // Block collision detection (X axis), only blocks around the player's path
+    findNearbyBlocks(blocks, std::min(mPosX, nextPosX), mPosY, std::max(mPosX, nextPosX)+PLAYER_WIDTH, mPosY+PLAYER_HEIGHT, nearbyBlocks);
+    for (size_t i : nearbyBlocks) {
+        Block &block=blocks[i];
         if (block.checkXCollision(mPosX, mPosY, nextPosX, mVelX, PLAYER_WIDTH, PLAYER_HEIGHT)) {
             mVelX=0.0;
-            if (block.getType()=="1WVI") block.interact(totalMoney, gainPerHit, passiveIncome, currentStatus,
-                                                  blocks, pushableBlocks, spikes, levelName, deltaTime,
-                                                  timeStopped, timeStopTimer, powerPercent, cutscenePlaying);
+            if (block.getType()==TILE_1WVI) block.interact(*this, currentStatus, blocks, pushableBlocks, spikes, behavior, deltaTime);
         }
     }
     for (auto &block : pushableBlocks) {
@@ -242,13 +263,13 @@ void Player::move(std::vector<Block> &blocks, std::vector<PushableBlock> &pushab
     hitCeiling=false;
 
     // Block collision detection (Y axis)
-    for (auto &block : blocks) {
+    findNearbyBlocks(blocks, mPosX, std::min(mPosY, nextPosY), mPosX+PLAYER_WIDTH, std::max(mPosY, nextPosY)+PLAYER_HEIGHT, nearbyBlocks);
+    for (size_t i : nearbyBlocks) {
+        Block &block=blocks[i];
         if (block.checkYCollision(mPosX, mPosY, nextPosY, mVelY, PLAYER_WIDTH, PLAYER_HEIGHT,
                                   onPlatform, hitCeiling, reverseGravity)) {
             if (!isDashing) mVelY=0.0;
-            if (onPlatform==false) block.interact(totalMoney, gainPerHit, passiveIncome, currentStatus,
-                                                  blocks, pushableBlocks, spikes, levelName, deltaTime,
-                                                  timeStopped, timeStopTimer, powerPercent, cutscenePlaying);
+            if (onPlatform==false) block.interact(*this, currentStatus, blocks, pushableBlocks, spikes, behavior, deltaTime);
         }
     }
     forcePushIntoGap(blocks);
@@ -288,41 +309,26 @@ void Player::move(std::vector<Block> &blocks, std::vector<PushableBlock> &pushab
 }
 
 // Helper function for spider pad interactions
-void Player::findClosestRectSPad(JumpPad pad, std::vector<Block> &blocks, std::vector<Spike> &spikes) {
+void Player::findClosestRectSPad(const JumpPad &pad, std::vector<Block> &blocks, std::vector<Spike> &spikes) {
 
-    // Player hitboxes
+    // Player hitboxes, blocks are tested against the whole player and spikes against the smaller spider pad one
     SDL_FRect normalHitbox=getHitbox();
     SDL_FRect SPadHitbox=getSPadHitbox();
+    float normalLeft=normalHitbox.x, normalRight=normalHitbox.x+normalHitbox.w;
+    float SPadLeft=SPadHitbox.x, SPadRight=SPadHitbox.x+SPadHitbox.w;
 
     // Teleport to ceiling
     if (pad.angle==0) {
         // Set up position to teleport to
         float closestPosY=0;
 
-        for (auto &block : blocks) {
-            if (block.getType()=="1J") continue;
-            SDL_FRect blockHitbox=block.getHitbox();
-            if (blockHitbox.x<normalHitbox.x+normalHitbox.w &&
-                blockHitbox.x+blockHitbox.w>normalHitbox.x && // If player hitbox inside platform
-                blockHitbox.y+blockHitbox.h<=normalHitbox.y) { // And below platform
+        // Closest platform above the player
+        float blockBottom=findBlockCeiling(blocks, normalLeft, normalRight, normalHitbox.y);
+        if (blockBottom>=closestPosY) closestPosY=blockBottom;
 
-                if (blockHitbox.y+blockHitbox.h>=closestPosY) {
-                    closestPosY=blockHitbox.y+blockHitbox.h;
-                }
-            }
-        }
-
-        for (const auto &spike : spikes) {
-            SDL_FRect spikeHitbox=spike.getHitbox();
-            if (spikeHitbox.x<=SPadHitbox.x+SPadHitbox.w &&
-                spikeHitbox.x+spikeHitbox.w>=SPadHitbox.x && // If player hitbox inside spike
-                spikeHitbox.y+spikeHitbox.h<=SPadHitbox.y) { // And below spike
-
-                if (spikeHitbox.y+spikeHitbox.h>=closestPosY) {
-                    closestPosY=spikeHitbox.y+spikeHitbox.h;
-                }
-            }
-        }
+        // Closest spike above the player
+        float spikeBottom=findSpikeCeiling(spikes, SPadLeft, SPadRight, SPadHitbox.y);
+        if (spikeBottom>=closestPosY) closestPosY=spikeBottom;
 
         reverseGravity=true;
         mPosY=closestPosY;
@@ -333,136 +339,32 @@ void Player::findClosestRectSPad(JumpPad pad, std::vector<Block> &blocks, std::v
         // Set up position to teleport to
         float closestPosY=SCREEN_HEIGHT;
 
-        for (auto &block : blocks) {
-            if (block.getType()=="1J") continue;
-            SDL_FRect blockHitbox=block.getHitbox();
-            if (blockHitbox.x<normalHitbox.x+normalHitbox.w &&
-                blockHitbox.x+blockHitbox.w>normalHitbox.x && // If player hitbox inside platform
-                blockHitbox.y>=normalHitbox.y+normalHitbox.h) { // And above platform
+        // Closest platform below the player
+        float blockTop=findBlockFloor(blocks, normalLeft, normalRight, normalHitbox.y+normalHitbox.h);
+        if (blockTop<=closestPosY+normalHitbox.h) closestPosY=blockTop-normalHitbox.h;
 
-                if (blockHitbox.y<=closestPosY+normalHitbox.h) {
-                    closestPosY=blockHitbox.y-normalHitbox.h;
-                }
-            }
-        }
-
-        for (const auto &spike : spikes) {
-            SDL_FRect spikeHitbox=spike.getHitbox();
-            if (spikeHitbox.x<=SPadHitbox.x+SPadHitbox.w &&
-                spikeHitbox.x+spikeHitbox.w>=SPadHitbox.x && // If player hitbox inside spike
-                spikeHitbox.y>=SPadHitbox.y+SPadHitbox.h) { // And above spike
-
-                if (spikeHitbox.y<=closestPosY+SPadHitbox.h) {
-                    closestPosY=spikeHitbox.y-SPadHitbox.h;
-                }
-            }
-        }
+        // Closest spike below the player
+        float spikeTop=findSpikeFloor(spikes, SPadLeft, SPadRight, SPadHitbox.y+SPadHitbox.h);
+        if (spikeTop<=closestPosY+SPadHitbox.h) closestPosY=spikeTop-SPadHitbox.h;
 
         reverseGravity=false;
         mPosY=closestPosY;
     }
 }
 
-// Jump orb and jump pad interactions
+// Level gimmicks, jump orb and jump pad interactions
 void Player::interact(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-                      std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads, const std::string &levelName, double deltaTime, bool &dead) {
-
-    // Idle tycoon
-    if (levelName=="Cookies") {
-        income+=passiveIncome*deltaTime;
-        if (income>=passiveIncome) {
-            totalMoney+=passiveIncome;
-            income=0;
-        }
-        if (totalMoney>1000000) {
-            for (auto &spike : spikes) {
-                if (!spike.unlocked) {
-                    spike.unlocked=true;
-                    spike.realX=SCREEN_WIDTH-TILE_SIZE*8-TILE_SIZE*7/18.0f+TILE_SIZE*2/5.0f;
-                    spike.realY=SCREEN_HEIGHT-TILE_SIZE*3-TILE_SIZE/2.0f+TILE_SIZE*3/10.0f;
-                }
-            }
-        }
-    }
-
-    // Time stop
-    else if (levelName=="Illusion World") {
-        if (timeStopped) {
-            SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 80);
-            SDL_FRect timeStopOverlay={TILE_SIZE*7/18, TILE_SIZE/2, SCREEN_WIDTH-TILE_SIZE*14/18, SCREEN_HEIGHT-TILE_SIZE};
-            SDL_RenderFillRectF(gRenderer, &timeStopOverlay);
-
-            timeStopTimer-=deltaTime;
-            if (timeStopTimer<0) {
-                timeStopped=false;
-                timeStopTimer=0;
-            }
-        }
-        else {
-            for (auto &block : pushableBlocks) {
-                if (block.resetQueued) {
-                    block.resetQueued=false;
-                    block.resetPosition();
-                }
-            }
-        }
-    }
+                      std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads, LevelBehavior &behavior, double deltaTime, bool &dead) {
+    PROFILE_SCOPE(ZONE_INTERACT);
 
-    // Fnaf puzzle
-    else if (levelName=="Five Nights") {
-        if (!powerOut) {
-            drain+=drainRate*deltaTime;
-            if (drain>=drainRate) {
-                powerPercent-=drainRate;
-                drain=0;
-            }
-        }
-        if (powerPercent==0) {
-            powerOut=true;
+    behavior.update(*this, blocks, pushableBlocks, spikes, deltaTime, dead);
 
-            SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 240);
-            SDL_FRect fnafOverlay={0, 0, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)};
-            SDL_RenderFillRectF(gRenderer, &fnafOverlay);
-        }
-        if (powerOut && !diedFromPowerOut) {
-            Mix_PlayMusic(fnafSong, 0);
-            diedFromPowerOut=true;
-        }
-        if (!Mix_PlayingMusic()) dead=true;
-    }
-
-    // Jojo reference
-    else if (levelName=="Star on Shoulder") {
-        if (cutscenePlaying && !roundaboutPlaying) {
-            Mix_PlayMusic(jojoSong, 0);
-            roundaboutPlaying=true;
-        }
-        levelFreeze=false;
-        for (const auto &block : blocks) {
-            if (block.getType()=="3ADM" && block.getHitbox().y>SCREEN_HEIGHT-3*TILE_SIZE) {
-                if (Mix_PlayingMusic()) levelFreeze=true;
-            }
-        }
-        if (levelFreeze) {
-            SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(gRenderer, 211, 211, 211, 80);
-            SDL_FRect cutsceneOverlay={TILE_SIZE*7/18, TILE_SIZE/2, SCREEN_WIDTH-TILE_SIZE*14/18, SCREEN_HEIGHT-TILE_SIZE};
-            SDL_RenderFillRectF(gRenderer, &cutsceneOverlay);
-
-            toBeContinued.render(0, SCREEN_HEIGHT-toBeContinued.getHeight());
-        }
-        if (!Mix_PlayingMusic()) {
-            cutscenePlaying=false;
-            levelFreeze=false;
-        }
-    }
-
-    // Orb interactions
-    for (auto &orb : jumpOrbs) {
-        if (orb.checkCollision(mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT) && isJumpHeld && canJump) {
-            char type=orb.getType();
+    // Orb interactions, every orb tested at once
+    syncHitboxes(jumpOrbHitboxes, jumpOrbs);
+    overlapHitboxes(jumpOrbHitboxes, mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT, hitMask);
+    for (size_t i=0; i<jumpOrbs.size(); i++) {
+        if (isHit(hitMask, i) && isJumpHeld && canJump) {
+            char type=jumpOrbs[i].getType();
             switch (type) {
             case 'Y': // Yellow orb
                 if (!reverseGravity) mVelY=JUMP_VELOCITY;
@@ -500,23 +402,26 @@ void Player::interact(std::vector<Block> &blocks, std::vector<PushableBlock> &pu
     }
 
     // Pad interactions
-    for (auto &pad : jumpPads) {
-        if (pad.checkCollision(mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT)) {
+    syncHitboxes(jumpPadHitboxes, jumpPads);
+    overlapHitboxes(jumpPadHitboxes, mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT, hitMask);
+    for (size_t i=0; i<jumpPads.size(); i++) {
+        JumpPad &pad=jumpPads[i];
+        if (isHit(hitMask, i)) {
             if (pad.canTrigger()) {
-                std::string type=pad.getType();
-                switch (type[0]) {
-                case 'J': // Yellow pad
+                uint32_t padFlags=tileInfo[pad.getType()].flags;
+                if (padFlags&FLAG_YELLOW_PAD) { // Yellow pad
                     if (!reverseGravity) mVelY=JUMP_VELOCITY*1.37;
                     else mVelY=-JUMP_VELOCITY*1.37;
-                    break;
-                case 'P': // Pink pad
+                }
+                else if (padFlags&FLAG_PINK_PAD) { // Pink pad
                     if (!reverseGravity) mVelY=JUMP_VELOCITY;
                     else mVelY=-JUMP_VELOCITY;
-                    break;
-                case 'S': // Spider pad
+                }
+                else if (padFlags&FLAG_SPIDER_PAD) { // Spider pad
                     findClosestRectSPad(pad, blocks, spikes);
                     mVelY=0;
-                    break;
+                    // Player was teleported, the rest of the pads have to be tested at the new position
+                    overlapHitboxes(jumpPadHitboxes, mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT, hitMask);
                 }
                 pad.markUsed();
             }
@@ -526,25 +431,25 @@ void Player::interact(std::vector<Block> &blocks, std::vector<PushableBlock> &pu
         }
     }
 
-    // Spike collision
-    for (auto &spike : spikes) {
-        if (!levelFreeze) spike.movingSpike(deltaTime);
-        if (spike.checkCollision(mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT)) {
-            dead=true;
-        }
+    // Spike collision, move blocks and spikes first then test every spike at once
+    syncHitboxes(spikeHitboxes, spikes);
+    if (!levelFreeze) updateMovers(blocks, spikes, deltaTime);
+    if (overlapHitboxes(spikeHitboxes, mPosX, mPosY, PLAYER_WIDTH, PLAYER_HEIGHT, hitMask)) {
+        dead=true;
     }
+}
 
-    for (auto &block : blocks) {
-        if (!levelFreeze) {
-            if (block.getType()=="1Y") block.movingBlockX(deltaTime);
-            else block.movingBlockY(deltaTime);
-        }
-    }
+// Remember the position at the start of a tick
+void Player::savePosition() {
+    mPrevPosX=mPosX;
+    mPrevPosY=mPosY;
 }
 
-// Render player to window
-void Player::render() {
+// Render player to window, alpha is how far the frame is between the last two ticks
+void Player::render(double alpha) {
     SDL_FRect cube=getHitbox();
+    cube.x=static_cast<float>(mPrevPosX+(mPosX-mPrevPosX)*alpha);
+    cube.y=static_cast<float>(mPrevPosY+(mPosY-mPrevPosY)*alpha);
     cubeTexture.render(cube, nullptr, 0.0, nullptr, (reverseGravity ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE));
 }
 
@@ -564,13 +469,15 @@ bool Player::getGravity() {
     return reverseGravity;
 }
 
-// Just for idle tycoon
-int Player::getGainPerHit() {
-    return gainPerHit;
-}
-int Player::getPassiveIncome() {
-    return passiveIncome;
-}
-unsigned long long Player::getTotalMoney() {
-    return totalMoney;
+// Hash of position and velocity rounded to cell pixels and the movement flags, for the level solver
+uint64_t Player::coarseState(float cell) {
+    int64_t parts[]={int64_t(floor(mPosX/cell)), int64_t(floor(mPosY/cell)),
+                     int64_t(floor(mVelX/(X_VELOCITY/2))), int64_t(floor(mVelY/(JUMP_VELOCITY/-8))),
+                     reverseGravity|onPlatform<<1|canJump<<2|isJumpHeld<<3|touchingOrb<<4|isDashing<<5|timeStopped<<6};
+    uint64_t hash=14695981039346656037ull;
+    for (int64_t part : parts) {
+        hash^=uint64_t(part);
+        hash*=1099511628211ull;
+    }
+    return hash;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <SDL.h>
 #include "LevelObjs.h"
@@ -9,6 +10,8 @@ extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
 extern const float TILE_SIZE;
 
+class LevelBehavior;
+
 class Player {
 public:
     // Player width
@@ -39,22 +42,29 @@ public:
     // Handle mouse + keyboard events
     void handleEvent(SDL_Event &e);
 
+    // Set the held keys directly (headless runs, replays)
+    void setInput(bool left, bool right, bool jump);
+    bool getJumpHeld();
+
     // Allow player to enter 1-block-wide gap
     void forcePushIntoGap(std::vector<Block> &blocks);
 
     // Move player, platform physics included, deltaTime for consistent physics
     void move(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-              std::vector<JumpOrb> &jumpOrbs, GameStatus &currentStatus, const std::string &levelName, double deltaTime);
+              std::vector<JumpOrb> &jumpOrbs, GameStatus &currentStatus, LevelBehavior &behavior, double deltaTime);
 
     // Helper function for spider pad interactions
-    void findClosestRectSPad(JumpPad pad, std::vector<Block> &blocks, std::vector<Spike> &spikes);
+    void findClosestRectSPad(const JumpPad &pad, std::vector<Block> &blocks, std::vector<Spike> &spikes);
 
-    // Jump orb and jump pad interactions
+    // Level gimmicks, jump orb and jump pad interactions
     void interact(std::vector<Block> &blocks, std::vector<PushableBlock> &pushableBlocks, std::vector<Spike> &spikes,
-                  std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads, const std::string &levelName, double deltaTime, bool &quit);
+                  std::vector<JumpOrb> &jumpOrbs, std::vector<JumpPad> &jumpPads, LevelBehavior &behavior, double deltaTime, bool &quit);
 
-    // Render player to window
-    void render();
+    // Remember the position at the start of a tick, rendering interpolates from there
+    void savePosition();
+
+    // Render player to window, alpha is how far the frame is between the last two ticks
+    void render(double alpha);
 
     // Get player hitbox, for spike collision
     SDL_FRect getHitbox();
@@ -65,11 +75,11 @@ public:
     // Get gravity status
     bool getGravity();
 
+    // Hash of position and velocity rounded to cell pixels and the movement flags, for the level solver
+    uint64_t coarseState(float cell);
+
     // Just for idle tycoon
-    unsigned long long getTotalMoney();
-    int getGainPerHit();
-    int getPassiveIncome();
-    double income=0;
+    Economy economy;
 
     // Check if player is moving left or right
     bool moveLeft, moveRight;
@@ -94,6 +104,9 @@ private:
     // Player X/Y positions
     double mPosX, mPosY;
 
+    // Position at the start of the current tick
+    double mPrevPosX, mPrevPosY;
+
     // Player X/Y velocities
     double mVelX, mVelY;
 
@@ -117,8 +130,9 @@ private:
     double coyoteTimer;
     static constexpr double COYOTE_TIME=0.03;
 
-    // Just for idle tycoon
-    unsigned long long totalMoney;
-    int gainPerHit;
-    int passiveIncome;
+    // Blocks close enough to collide with, reused every frame
+    std::vector<size_t> nearbyBlocks;
+
+    // Bit mask of the objects the player touches, reused every frame
+    std::vector<uint64_t> hitMask;
 };
@@ -0,0 +1,216 @@
+#ifdef DTW_PROFILING
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+#include "SpriteBatch.h"
+#include "GlyphAtlas.h"
+#include "Profiler.h"
+
+extern SDL_Renderer *gRenderer;
+
+static const char *zoneName[TOTAL_ZONE]={"events", "move", "interact", "pushables", "renderLevel", "text", "overlay", "present"};
+
+Uint64 profileTicks[TOTAL_ZONE];
+
+// Milliseconds per frame, the last column is the whole frame
+static double history[PROFILE_HISTORY][TOTAL_ZONE+1];
+static double historySum[TOTAL_ZONE+1];
+static int historyNext=0;
+static int historyCount=0;
+static Uint64 lastFrame=0;
+static bool overlayVisible=false;
+
+// Trace being recorded, workers only append under the mutex
+struct TraceEvent {
+    const char *name;
+    char detail[48];
+    Uint64 start, end;
+    SDL_threadID thread;
+};
+
+SDL_atomic_t traceRecording;
+static SDL_mutex *traceMutex=nullptr;
+static std::vector<TraceEvent> traceEvents;
+static std::string tracePath;
+static int traceFramesLeft=0;
+static Uint64 traceStart=0;
+static Uint64 traceFrameStart=0;
+static SDL_threadID traceMainThread=0;
+
+void traceSpan(const char *name, const char *detail, Uint64 start, Uint64 end) {
+    TraceEvent event;
+    event.name=name;
+    event.detail[0]='\0';
+    if (detail!=nullptr) {
+        strncpy(event.detail, detail, sizeof(event.detail)-1);
+        event.detail[sizeof(event.detail)-1]='\0';
+    }
+    event.start=start;
+    event.end=end;
+    event.thread=SDL_ThreadID();
+    SDL_LockMutex(traceMutex);
+    traceEvents.push_back(event);
+    SDL_UnlockMutex(traceMutex);
+}
+
+void traceZone(ProfileZone zone, Uint64 start, Uint64 end) {
+    traceSpan(zoneName[zone], nullptr, start, end);
+}
+
+void startTrace(const std::string &path, int frames) {
+    if (SDL_AtomicGet(&traceRecording) || frames<=0) return;
+    if (traceMutex==nullptr) traceMutex=SDL_CreateMutex();
+    SDL_LockMutex(traceMutex);
+    traceEvents.clear();
+    traceEvents.reserve(frames*32);
+    SDL_UnlockMutex(traceMutex);
+    tracePath=path;
+    traceFramesLeft=frames;
+    traceStart=traceFrameStart=SDL_GetPerformanceCounter();
+    traceMainThread=SDL_ThreadID();
+    SDL_AtomicSet(&traceRecording, 1);
+    std::cout << "Tracing the next " << frames << " frames to " << path << std::endl;
+}
+
+// Text from the level (rendered strings, paths) can hold anything
+static void writeJsonString(std::ofstream &file, const char *text) {
+    file << '"';
+    for (const char *c=text; *c!='\0'; c++) {
+        if (*c=='"' || *c=='\\') file << '\\' << *c;
+        else if ((unsigned char)*c<0x20) file << ' ';
+        else file << *c;
+    }
+    file << '"';
+}
+
+void finishTrace() {
+    if (!SDL_AtomicGet(&traceRecording)) return;
+    SDL_AtomicSet(&traceRecording, 0);
+
+    std::ofstream file(tracePath);
+    if (!file.is_open()) {
+        std::cout << "Failed to write trace: " << tracePath << std::endl;
+        return;
+    }
+    // Timestamps are in microseconds from the start of the trace
+    double toMicroseconds=1000000.0/SDL_GetPerformanceFrequency();
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << traceMainThread << ",\"args\":{\"name\":\"main\"}}";
+    SDL_LockMutex(traceMutex);
+    for (const auto &event : traceEvents) {
+        file << ",\n{\"name\":";
+        writeJsonString(file, event.name);
+        file << ",\"cat\":\"" << (event.thread==traceMainThread ? "main" : "worker") << "\",\"ph\":\"X\",\"ts\":"
+             << (event.start-traceStart)*toMicroseconds << ",\"dur\":" << (event.end-event.start)*toMicroseconds
+             << ",\"pid\":1,\"tid\":" << event.thread;
+        if (event.detail[0]!='\0') {
+            file << ",\"args\":{\"detail\":";
+            writeJsonString(file, event.detail);
+            file << '}';
+        }
+        file << '}';
+    }
+    std::cout << "Trace of " << traceEvents.size() << " spans written to " << tracePath << std::endl;
+    traceEvents.clear();
+    traceEvents.shrink_to_fit();
+    SDL_UnlockMutex(traceMutex);
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void profilerEndFrame() {
+    Uint64 now=SDL_GetPerformanceCounter();
+    if (SDL_AtomicGet(&traceRecording)) {
+        traceSpan("frame", nullptr, traceFrameStart, now);
+        traceFrameStart=now;
+        if (--traceFramesLeft==0) finishTrace();
+    }
+    double toMilliseconds=1000.0/SDL_GetPerformanceFrequency();
+
+    // Overwrite the oldest frame once the history is full, keeping the sums in step
+    double *row=history[historyNext];
+    if (historyCount==PROFILE_HISTORY) {
+        for (int zone=0; zone<=TOTAL_ZONE; zone++) historySum[zone]-=row[zone];
+    }
+    else {
+        historyCount++;
+    }
+    for (int zone=0; zone<TOTAL_ZONE; zone++) {
+        row[zone]=profileTicks[zone]*toMilliseconds;
+        profileTicks[zone]=0;
+    }
+    row[TOTAL_ZONE]=(lastFrame==0 ? 0 : (now-lastFrame)*toMilliseconds);
+    for (int zone=0; zone<=TOTAL_ZONE; zone++) historySum[zone]+=row[zone];
+    historyNext=(historyNext+1)%PROFILE_HISTORY;
+    lastFrame=now;
+}
+
+bool profilerHandleEvent(const SDL_Event &e) {
+    if (e.type!=SDL_KEYDOWN) return false;
+    if (e.key.keysym.sym==SDLK_F3) {
+        overlayVisible=!overlayVisible;
+        return true;
+    }
+    if (e.key.keysym.sym==SDLK_F4) {
+        if (dumpProfile("Profile.csv")) std::cout << "Profile written to Profile.csv" << std::endl;
+        return true;
+    }
+    if (e.key.keysym.sym==SDLK_F5) {
+        startTrace("Trace.json", DEFAULT_TRACE_FRAMES);
+        return true;
+    }
+    return false;
+}
+
+void renderProfilerOverlay(GlyphAtlas &font) {
+    if (!overlayVisible || historyCount==0) return;
+
+    const float left=8, top=font.getHeight()+8;
+    const float lineHeight=font.getHeight()*0.8f;
+    const float graphHeight=100, graphTop=top+lineHeight*(TOTAL_ZONE+1)+8;
+    const double graphScale=graphHeight/33.3; // 30 fps at the top, 60 fps halfway
+
+    static SpriteBatch panel;
+    panel.addRect({left, top, PROFILE_HISTORY+16.0f, graphTop+graphHeight+8-top}, {0, 0, 0, 180});
+
+    // One bar per frame, oldest on the left
+    for (int i=0; i<historyCount; i++) {
+        int index=(historyNext-historyCount+i+PROFILE_HISTORY)%PROFILE_HISTORY;
+        double frameTime=history[index][TOTAL_ZONE];
+        float barHeight=float(std::min(frameTime*graphScale, double(graphHeight)));
+        SDL_Color color=(frameTime>16.7 ? SDL_Color{255, 80, 80, 255} : SDL_Color{80, 255, 80, 255});
+        panel.addRect({left+8+i, graphTop+graphHeight-barHeight, 1, barHeight}, color);
+    }
+    panel.addRect({left+8, float(graphTop+graphHeight-16.7*graphScale), float(PROFILE_HISTORY), 1}, {255, 255, 255, 120});
+    SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+    panel.flush();
+
+    char line[64];
+    for (int zone=0; zone<=TOTAL_ZONE; zone++) {
+        snprintf(line, sizeof(line), "%s %.3f ms", zone<TOTAL_ZONE ? zoneName[zone] : "frame", historySum[zone]/historyCount);
+        font.render(line, left+8, top+lineHeight*zone);
+    }
+    font.flush();
+}
+
+bool dumpProfile(const std::string &path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cout << "Failed to write profile: " << path << std::endl;
+        return false;
+    }
+    for (int zone=0; zone<TOTAL_ZONE; zone++) file << zoneName[zone] << "_ms,";
+    file << "frame_ms\n";
+    for (int i=0; i<historyCount; i++) {
+        const double *row=history[(historyNext-historyCount+i+PROFILE_HISTORY)%PROFILE_HISTORY];
+        for (int zone=0; zone<=TOTAL_ZONE; zone++) file << row[zone] << (zone<TOTAL_ZONE ? ',' : '\n');
+    }
+    return true;
+}
+
+#endif
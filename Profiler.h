@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <SDL.h>
+
+// Scoped timers around the hot paths, built only with -DDTW_PROFILING (on in the Debug target)
+// Without it every PROFILE_ macro expands to nothing
+// The same timers, plus a few one-off spans, can be recorded as a Chrome/Perfetto trace (chrome://tracing, ui.perfetto.dev)
+
+// Timed parts of a frame, in overlay order
+enum ProfileZone {
+    ZONE_EVENTS,
+    ZONE_MOVE,
+    ZONE_INTERACT,
+    ZONE_PUSHABLES,
+    ZONE_RENDER_LEVEL,
+    ZONE_TEXT,
+    ZONE_OVERLAY,
+    ZONE_PRESENT,
+    TOTAL_ZONE
+};
+
+// Frames kept for the rolling averages, the graph and the CSV dump
+const int PROFILE_HISTORY=240;
+
+// Frames a trace covers unless --trace-frames says otherwise
+const int DEFAULT_TRACE_FRAMES=600;
+
+#ifdef DTW_PROFILING
+
+class GlyphAtlas;
+
+// Performance counter ticks spent in each zone this frame
+extern Uint64 profileTicks[TOTAL_ZONE];
+
+// Set while a trace is being recorded, spans may come from any thread
+extern SDL_atomic_t traceRecording;
+
+// Add a span to the trace, detail (may be nullptr) is shown as its argument
+void traceSpan(const char *name, const char *detail, Uint64 start, Uint64 end);
+void traceZone(ProfileZone zone, Uint64 start, Uint64 end);
+
+// Adds the time from construction to stop() (or the end of the scope) to a zone
+class ProfileTimer {
+public:
+    explicit ProfileTimer(ProfileZone zone) : zone(zone), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileTimer() { stop(); }
+    void stop() {
+        if (start==0) return;
+        Uint64 end=SDL_GetPerformanceCounter();
+        profileTicks[zone]+=end-start;
+        if (SDL_AtomicGet(&traceRecording)) traceZone(zone, start, end);
+        start=0;
+    }
+
+private:
+    ProfileZone zone;
+    Uint64 start;
+};
+
+// A span that only goes into the trace, for work outside the frame zones (loading, rasterizing)
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name, const char *detail=nullptr)
+        : name(name), detail(detail), start(SDL_AtomicGet(&traceRecording) ? SDL_GetPerformanceCounter() : 0) {}
+    ~TraceSpan() {
+        if (start!=0) traceSpan(name, detail, start, SDL_GetPerformanceCounter());
+    }
+
+private:
+    const char *name;
+    const char *detail;
+    Uint64 start;
+};
+
+// Close the frame: move this frame's zone times into the history
+void profilerEndFrame();
+
+// F3 shows/hides the overlay, F4 writes the history to Profile.csv, F5 traces the next frames to Trace.json
+// True if the event was one of them
+bool profilerHandleEvent(const SDL_Event &e);
+
+// Record every span of the next frames, the trace is written to path once they are done
+void startTrace(const std::string &path, int frames);
+
+// Write a trace still being recorded (quitting before the frames are done)
+void finishTrace();
+
+// Rolling averages and a frame time graph in the top left corner
+void renderProfilerOverlay(GlyphAtlas &font);
+
+// Write the history, one row per frame, oldest first
+bool dumpProfile(const std::string &path);
+
+#define PROFILE_SCOPE(zone) ProfileTimer profileTimer_##zone(zone)
+#define PROFILE_START(zone) ProfileTimer profileTimer_##zone(zone)
+#define PROFILE_STOP(zone) profileTimer_##zone.stop()
+#define PROFILE_END_FRAME() profilerEndFrame()
+#define PROFILE_HANDLE_EVENT(e) profilerHandleEvent(e)
+#define PROFILE_OVERLAY(font) renderProfilerOverlay(font)
+#define PROFILE_SPAN(name) TraceSpan traceSpan_(name)
+#define PROFILE_SPAN_DETAIL(name, detail) TraceSpan traceSpan_(name, detail)
+#define PROFILE_START_TRACE(path, frames) startTrace(path, frames)
+#define PROFILE_FINISH_TRACE() finishTrace()
+
+#else
+
+#define PROFILE_SCOPE(zone)
+#define PROFILE_START(zone)
+#define PROFILE_STOP(zone)
+#define PROFILE_END_FRAME()
+#define PROFILE_HANDLE_EVENT(e) false
+#define PROFILE_OVERLAY(font)
+#define PROFILE_SPAN(name)
+#define PROFILE_SPAN_DETAIL(name, detail)
+#define PROFILE_START_TRACE(path, frames)
+#define PROFILE_FINISH_TRACE()
+
+#endif
@@ -1,133 +1,273 @@
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <SDL.h>
 #include "Texture.h"
 #include "LevelObjs.h"
 #include "LoadLevel.h"
+#include "Player.h"
+#include "SpriteBatch.h"
+#include "Rendering.h"
+#include "Profiler.h"
 
 extern SDL_Renderer *gRenderer;
 
 extern LTexture blockSheetTexture;
 extern LTexture orbPadSheetTexture;
+extern LTexture toBeContinued;
 
 extern SDL_Rect blockClips[];
 extern SDL_Rect spikeClips[];
 extern SDL_Rect orbClips[];
 extern SDL_Rect padClips[];
 
-void renderLevel(const std::vector<Block> &blocks, const std::vector<PushableBlock> &pushableBlocks, const std::vector<Spike> &spikes,
-                 const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads, double deltaTime) {
-    // Render orbs
-    for (const auto &orb : jumpOrbs) {
-        SDL_FRect renderOrb={orb.getHitbox().x+TILE_SIZE/10, orb.getHitbox().y+TILE_SIZE/10, TILE_SIZE, TILE_SIZE};
-        switch (orb.getType()) {
-        case 'Y': // Yellow
-            orbPadSheetTexture.render(renderOrb, &orbClips[0], 0, nullptr, SDL_FLIP_NONE);
-            break;
-        case 'B': // Blue
-            orbPadSheetTexture.render(renderOrb, &orbClips[1], 0, nullptr, SDL_FLIP_NONE);
-            break;
-        case 'G': // Green
-            orb.updateRotation(deltaTime);
-            orbPadSheetTexture.render(renderOrb, &orbClips[2], orb.rotationAngle, nullptr, SDL_FLIP_NONE);
-            break;
-        case 'D': // Dash
-            orbPadSheetTexture.render(renderOrb, &orbClips[3], 0, nullptr, SDL_FLIP_NONE);
-            break;
-        }
+// Everything from one sheet goes out in a single draw call, tints are drawn over the blocks and pushable blocks
+// over the tints, like when every sprite was drawn on its own
+static SpriteBatch orbPadBatch(&orbPadSheetTexture);
+static SpriteBatch blockBatch(&blockSheetTexture);
+static SpriteBatch tintBatch;
+static SpriteBatch pushableBatch(&blockSheetTexture);
+
+// Static layers: orbs, pads, spikes and blocks that never changed since the level loaded, drawn once into textures
+// Green orbs go under the orbs and pads layer, moving spikes between it and the spikes and blocks layer, changed blocks
+// over both, same order as drawing everything every frame
+enum StaticLayer {
+    STATIC_ORBS_PADS,
+    STATIC_SPIKES_BLOCKS,
+    TOTAL_STATIC_LAYER
+};
+static SDL_Texture *staticLayer[TOTAL_STATIC_LAYER]={};
+static bool staticLayerUnsupported=false; // No render targets or no premultiplied blending, draw everything every frame
+static bool staticLayerValid=false;
+static const std::vector<Block> *staticLayerSource=nullptr;
+static unsigned int staticLayerLevel=0, staticLayerObjects=0;
+static size_t staticLayerCounts[4]={};
+
+static bool isStaticOrb(const JumpOrb &orb) {
+    return orb.getType()!='G'; // Green orbs spin
+}
+
+static void addOrb(const JumpOrb &orb) {
+    SDL_FRect renderOrb={orb.getHitbox().x+TILE_SIZE/10, orb.getHitbox().y+TILE_SIZE/10, TILE_SIZE, TILE_SIZE};
+    switch (orb.getType()) {
+    case 'Y': // Yellow
+        orbPadBatch.add(renderOrb, orbClips[0]);
+        break;
+    case 'B': // Blue
+        orbPadBatch.add(renderOrb, orbClips[1]);
+        break;
+    case 'G': // Green
+        orbPadBatch.add(renderOrb, orbClips[2], orb.rotationAngle);
+        break;
+    case 'D': // Dash
+        orbPadBatch.add(renderOrb, orbClips[3]);
+        break;
     }
+}
 
-    // Render pads
-    for (const auto &pad : jumpPads) {
-        std::string type=pad.getType();
-        if (jumpPadLookup.find(type)!=jumpPadLookup.end()) {
-            JumpPadInfo info=jumpPadLookup[type];
-            SDL_FRect renderPad;
-            if (type[0]=='J' || type[0]=='P') {
-                if (info.rotation==0) {
-                    renderPad={pad.getHitbox().x-TILE_SIZE/12, pad.getHitbox().y-TILE_SIZE*13/15, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==180) {
-                    renderPad={pad.getHitbox().x-TILE_SIZE/12, pad.getHitbox().y+TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
-                }
+static void addPad(const JumpPad &pad) {
+    const TileInfo &info=tileInfo[pad.getType()];
+    if (info.flags&FLAG_PAD) {
+        SDL_FRect renderPad;
+        if (!(info.flags&FLAG_SPIDER_PAD)) {
+            if (info.rotation==0) {
+                renderPad={pad.getHitbox().x-TILE_SIZE/12, pad.getHitbox().y-TILE_SIZE*13/15, TILE_SIZE, TILE_SIZE};
             }
-            else if (type[0]=='S') { // Spider
-                if (info.rotation==0) {
-                    renderPad={pad.getHitbox().x-TILE_SIZE/30, pad.getHitbox().y-TILE_SIZE*3/4, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==90) {
-                    renderPad={pad.getHitbox().x+TILE_SIZE*3/20, pad.getHitbox().y-TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==180) {
-                    renderPad={pad.getHitbox().x-TILE_SIZE/30, pad.getHitbox().y+TILE_SIZE*3/20, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==270) {
-                    renderPad={pad.getHitbox().x-TILE_SIZE*3/4, pad.getHitbox().y-TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
-                }
+            else if (info.rotation==180) {
+                renderPad={pad.getHitbox().x-TILE_SIZE/12, pad.getHitbox().y+TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
             }
-            orbPadSheetTexture.render(renderPad, &padClips[info.clipIndex], info.rotation, nullptr, SDL_FLIP_NONE);
         }
-    }
-
-    // Render spikes
-    for (const auto &spike : spikes) {
-        std::string type=spike.getType();
-        if (spikeLookup.find(type)!=spikeLookup.end()) {
-            SpikeInfo info=spikeLookup[type];
-            SDL_FRect renderSpike;
-            if (type[1]=='A' || type[1]=='C') { // Small spike
-                if (info.rotation==0) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE*2/5, spike.getHitbox().y-TILE_SIZE*7/10, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==90) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE/10, spike.getHitbox().y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==180) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE*2/5, spike.getHitbox().y-TILE_SIZE/10, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==270) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE*7/10, spike.getHitbox().y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
-                }
+        else { // Spider
+            if (info.rotation==0) {
+                renderPad={pad.getHitbox().x-TILE_SIZE/30, pad.getHitbox().y-TILE_SIZE*3/4, TILE_SIZE, TILE_SIZE};
+            }
+            else if (info.rotation==90) {
+                renderPad={pad.getHitbox().x+TILE_SIZE*3/20, pad.getHitbox().y-TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
             }
-            else if (type[1]=='E') { // Big spike
-                if (info.rotation==0 || info.rotation==180) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE*2/5, spike.getHitbox().y-TILE_SIZE*3/10, TILE_SIZE, TILE_SIZE};
-                }
-                else if (info.rotation==90 || info.rotation==270) {
-                    renderSpike={spike.getHitbox().x-TILE_SIZE*3/10, spike.getHitbox().y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
-                }
+            else if (info.rotation==180) {
+                renderPad={pad.getHitbox().x-TILE_SIZE/30, pad.getHitbox().y+TILE_SIZE*3/20, TILE_SIZE, TILE_SIZE};
+            }
+            else if (info.rotation==270) {
+                renderPad={pad.getHitbox().x-TILE_SIZE*3/4, pad.getHitbox().y-TILE_SIZE/30, TILE_SIZE, TILE_SIZE};
             }
-            blockSheetTexture.render(renderSpike, &spikeClips[info.clipIndex], info.rotation, nullptr, info.mirrored);
         }
+        orbPadBatch.add(renderPad, padClips[info.clipIndex], info.rotation);
     }
+}
 
-    // Render platforms (blocks)
-    for (const auto &block : blocks) {
-        std::string type=block.getType();
-        if (blockLookup.find(type)!=blockLookup.end()) {
-            BlockInfo info=blockLookup[type];
-            SDL_FRect renderBlock=block.getHitbox();
-            blockSheetTexture.render(renderBlock, &blockClips[info.clipIndex], info.rotation, nullptr, info.mirrored);
-            if (type=="1BG") {
-                SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(gRenderer, 0, 255, 0, 160);
-                SDL_RenderFillRectF(gRenderer, &block.getHitbox());
+static void addSpike(const Spike &spike, double alpha) {
+    const TileInfo &info=tileInfo[spike.getType()];
+    if (info.flags&FLAG_SPIKE) {
+        SDL_FRect spikeHitbox=spike.getRenderHitbox(alpha);
+        SDL_FRect renderSpike;
+        if (!(info.flags&FLAG_BIG_SPIKE)) { // Small spike
+            if (info.rotation==0) {
+                renderSpike={spikeHitbox.x-TILE_SIZE*2/5, spikeHitbox.y-TILE_SIZE*7/10, TILE_SIZE, TILE_SIZE};
+            }
+            else if (info.rotation==90) {
+                renderSpike={spikeHitbox.x-TILE_SIZE/10, spikeHitbox.y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
             }
-            if (type=="1BO") {
-                SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(gRenderer, 255, 102, 0, 160);
-                SDL_RenderFillRectF(gRenderer, &block.getHitbox());
+            else if (info.rotation==180) {
+                renderSpike={spikeHitbox.x-TILE_SIZE*2/5, spikeHitbox.y-TILE_SIZE/10, TILE_SIZE, TILE_SIZE};
             }
-            if (type=="1BY") {
-                SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(gRenderer, 255, 204, 0, 200);
-                SDL_RenderFillRectF(gRenderer, &block.getHitbox());
+            else if (info.rotation==270) {
+                renderSpike={spikeHitbox.x-TILE_SIZE*7/10, spikeHitbox.y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
             }
         }
+        else { // Big spike
+            if (info.rotation==0 || info.rotation==180) {
+                renderSpike={spikeHitbox.x-TILE_SIZE*2/5, spikeHitbox.y-TILE_SIZE*3/10, TILE_SIZE, TILE_SIZE};
+            }
+            else if (info.rotation==90 || info.rotation==270) {
+                renderSpike={spikeHitbox.x-TILE_SIZE*3/10, spikeHitbox.y-TILE_SIZE*2/5, TILE_SIZE, TILE_SIZE};
+            }
+        }
+        blockBatch.add(renderSpike, spikeClips[info.clipIndex], info.rotation, info.mirrored);
+    }
+}
+
+static void addBlock(const Block &block, double alpha) {
+    TileType type=block.getType();
+    const TileInfo &info=tileInfo[type];
+    if (info.flags&FLAG_BLOCK) {
+        SDL_FRect renderBlock=block.getRenderHitbox(alpha);
+        blockBatch.add(renderBlock, blockClips[info.clipIndex], info.rotation, info.mirrored);
+        if (type==TILE_1BG) tintBatch.addRect(renderBlock, {0, 255, 0, 160});
+        if (type==TILE_1BO) tintBatch.addRect(renderBlock, {255, 102, 0, 160});
+        if (type==TILE_1BY) tintBatch.addRect(renderBlock, {255, 204, 0, 200});
+    }
+}
+
+// Redraw the static layer if the level or anything in it changed, false when it can't be used
+static bool updateStaticLayer(const std::vector<Block> &blocks, const std::vector<Spike> &spikes,
+                              const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads) {
+    if (staticLayerUnsupported) return false;
+    size_t counts[4]={blocks.size(), spikes.size(), jumpOrbs.size(), jumpPads.size()};
+    if (staticLayerValid && staticLayerSource==&blocks && staticLayerLevel==levelRevision &&
+        staticLayerObjects==staticRevision && std::equal(counts, counts+4, staticLayerCounts)) return true;
+
+    for (int layer=0; layer<TOTAL_STATIC_LAYER; layer++) {
+        if (staticLayer[layer]!=nullptr) continue;
+        staticLayer[layer]=SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+        // Sprites blended onto a clear texture end up premultiplied, so the layer is composited as premultiplied
+        SDL_BlendMode premultiplied=SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                               SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if (staticLayer[layer]==nullptr || SDL_SetTextureBlendMode(staticLayer[layer], premultiplied)!=0) {
+            staticLayerUnsupported=true;
+            freeStaticLayer();
+            return false;
+        }
+    }
+
+    // Keep the draw state of the frame being rendered
+    SDL_BlendMode blendMode;
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawBlendMode(gRenderer, &blendMode);
+    SDL_GetRenderDrawColor(gRenderer, &r, &g, &b, &a);
+
+    SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 0);
+    SDL_SetRenderTarget(gRenderer, staticLayer[STATIC_ORBS_PADS]);
+    SDL_RenderClear(gRenderer);
+    for (const auto &orb : jumpOrbs) {
+        if (isStaticOrb(orb)) addOrb(orb);
     }
+    for (const auto &pad : jumpPads) addPad(pad);
+    orbPadBatch.flush();
+    SDL_SetRenderTarget(gRenderer, staticLayer[STATIC_SPIKES_BLOCKS]);
+    SDL_RenderClear(gRenderer);
+    for (const auto &spike : spikes) {
+        if (!spike.isDynamic()) addSpike(spike, 1.0);
+    }
+    for (const auto &block : blocks) {
+        if (!block.isDynamic()) addBlock(block, 1.0);
+    }
+    blockBatch.flush();
+    tintBatch.flush();
+    SDL_SetRenderTarget(gRenderer, nullptr);
+    SDL_SetRenderDrawBlendMode(gRenderer, blendMode);
+    SDL_SetRenderDrawColor(gRenderer, r, g, b, a);
+
+    staticLayerValid=true;
+    staticLayerSource=&blocks;
+    staticLayerLevel=levelRevision;
+    staticLayerObjects=staticRevision;
+    std::copy(counts, counts+4, staticLayerCounts);
+    return true;
+}
+
+void invalidateStaticLayer() {
+    staticLayerValid=false;
+}
+
+void freeStaticLayer() {
+    for (int layer=0; layer<TOTAL_STATIC_LAYER; layer++) {
+        if (staticLayer[layer]!=nullptr) SDL_DestroyTexture(staticLayer[layer]);
+        staticLayer[layer]=nullptr;
+    }
+    staticLayerValid=false;
+}
+
+void renderLevel(const std::vector<Block> &blocks, const std::vector<PushableBlock> &pushableBlocks, const std::vector<Spike> &spikes,
+                 const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads, double alpha) {
+    PROFILE_SCOPE(ZONE_RENDER_LEVEL);
+    bool layered=updateStaticLayer(blocks, spikes, jumpOrbs, jumpPads);
+
+    // Render orbs and pads
+    for (const auto &orb : jumpOrbs) {
+        if (!layered || !isStaticOrb(orb)) addOrb(orb);
+    }
+    if (!layered) {
+        for (const auto &pad : jumpPads) addPad(pad);
+    }
+    orbPadBatch.flush();
+    if (layered) SDL_RenderCopy(gRenderer, staticLayer[STATIC_ORBS_PADS], nullptr, nullptr);
+
+    // Render spikes, then platforms (blocks) over them
+    for (const auto &spike : spikes) {
+        if (!layered || spike.isDynamic()) addSpike(spike, alpha);
+    }
+    if (layered) {
+        blockBatch.flush();
+        SDL_RenderCopy(gRenderer, staticLayer[STATIC_SPIKES_BLOCKS], nullptr, nullptr);
+    }
+    for (const auto &block : blocks) {
+        if (!layered || block.isDynamic()) addBlock(block, alpha);
+    }
+    blockBatch.flush();
+    tintBatch.flush();
 
     for (const auto &block : pushableBlocks) {
-        SDL_FRect renderBlock=block.getHitbox();
-        blockSheetTexture.render(renderBlock, &blockClips[17], 0, nullptr, SDL_FLIP_NONE);
+        SDL_FRect renderBlock=block.getRenderHitbox(alpha);
+        pushableBatch.add(renderBlock, blockClips[17]);
+    }
+    pushableBatch.flush();
+}
+
+void renderLevelOverlay(const Player &cube, const std::string &levelName) {
+    PROFILE_SCOPE(ZONE_OVERLAY);
+    // Time stop
+    if (levelName=="Illusion World" && cube.timeStopped) {
+        SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 80);
+        SDL_FRect timeStopOverlay={TILE_SIZE*7/18, TILE_SIZE/2, SCREEN_WIDTH-TILE_SIZE*14/18, SCREEN_HEIGHT-TILE_SIZE};
+        SDL_RenderFillRectF(gRenderer, &timeStopOverlay);
+    }
+
+    // Fnaf puzzle, power out
+    else if (levelName=="Five Nights" && cube.powerPercent==0) {
+        SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 240);
+        SDL_FRect fnafOverlay={0, 0, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)};
+        SDL_RenderFillRectF(gRenderer, &fnafOverlay);
+    }
+
+    // Jojo reference, frozen cutscene
+    else if (levelName=="Star on Shoulder" && cube.levelFreeze) {
+        SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(gRenderer, 211, 211, 211, 80);
+        SDL_FRect cutsceneOverlay={TILE_SIZE*7/18, TILE_SIZE/2, SCREEN_WIDTH-TILE_SIZE*14/18, SCREEN_HEIGHT-TILE_SIZE};
+        SDL_RenderFillRectF(gRenderer, &cutsceneOverlay);
+
+        toBeContinued.render(0, SCREEN_HEIGHT-toBeContinued.getHeight());
     }
 }
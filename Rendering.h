@@ -1,7 +1,20 @@
 #pragma once
 
+#include <string>
 #include <vector>
 extern const float TILE_SIZE;
 
+class Player;
+
+// The static layer is redrawn by itself when the level changes, this throws it away early (render targets lost)
+void invalidateStaticLayer();
+
+// Free the static layer textures, before the renderer is destroyed
+void freeStaticLayer();
+
+// Moving objects are drawn between their last two tick positions (alpha from the timestep)
 void renderLevel(const std::vector<Block> &blocks, const std::vector<PushableBlock> &pushableBlocks, const std::vector<Spike> &spikes,
-                 const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads, double deltaTime);
+                 const std::vector<JumpOrb> &jumpOrbs, const std::vector<JumpPad> &jumpPads, double alpha);
+
+// Level specific screen overlays (time stop, power out, cutscene)
+void renderLevelOverlay(const Player &cube, const std::string &levelName);
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include "Player.h"
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "Timestep.h"
+#include "TicTacToe.h"
+#include "Replay.h"
+
+void ReplayAttempt::append(uint8_t keys) {
+    tickCount++;
+    if (!runs.empty()) {
+        uint32_t &last=runs.back();
+        if ((last>>REPLAY_RUN_KEY_SHIFT)==keys && (last&REPLAY_RUN_TICKS)<REPLAY_RUN_TICKS) {
+            last++;
+            return;
+        }
+    }
+    runs.push_back((uint32_t(keys)<<REPLAY_RUN_KEY_SHIFT)|1);
+}
+
+ReplayReader::ReplayReader(const ReplayAttempt &attempt) : attempt(&attempt) {}
+
+bool ReplayReader::next(uint8_t &keys) {
+    while (run<attempt->runs.size() && used>=(attempt->runs[run]&REPLAY_RUN_TICKS)) {
+        run++;
+        used=0;
+    }
+    if (run>=attempt->runs.size()) return false;
+    keys=attempt->runs[run]>>REPLAY_RUN_KEY_SHIFT;
+    used++;
+    return true;
+}
+
+bool loadReplay(const std::string &path, Replay &replay) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Failed to open replay file: " << path << std::endl;
+        return false;
+    }
+
+    ReplayFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic))!=0 || header.version!=REPLAY_FILE_VERSION) {
+        std::cout << "Unsupported replay file." << std::endl;
+        return false;
+    }
+
+    replay.tickRate=header.tickRate;
+    replay.botDifficulty=header.botDifficulty;
+    replay.attempts.clear();
+    for (uint32_t i=0; i<header.attemptCount; i++) {
+        ReplayFileAttempt record;
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            std::cout << "Replay file is corrupted." << std::endl;
+            return false;
+        }
+        ReplayAttempt attempt;
+        attempt.seed=record.seed;
+        attempt.tickCount=record.tickCount;
+        attempt.endHash=record.endHash;
+        attempt.levelName.resize(record.nameLength);
+        attempt.runs.resize(record.runCount);
+        if (!file.read(&attempt.levelName[0], record.nameLength) ||
+            !file.read(reinterpret_cast<char*>(attempt.runs.data()), record.runCount*sizeof(uint32_t))) {
+            std::cout << "Replay file is corrupted." << std::endl;
+            return false;
+        }
+
+        // The runs have to add up to the tick count
+        uint64_t ticks=0;
+        for (uint32_t run : attempt.runs) ticks+=run&REPLAY_RUN_TICKS;
+        if (ticks!=attempt.tickCount) {
+            std::cout << "Replay file is corrupted." << std::endl;
+            return false;
+        }
+        replay.attempts.push_back(std::move(attempt));
+    }
+    return true;
+}
+
+bool saveReplay(const std::string &path, const Replay &replay) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Failed to write replay file: " << path << std::endl;
+        return false;
+    }
+
+    ReplayFileHeader header;
+    memcpy(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic));
+    header.version=REPLAY_FILE_VERSION;
+    header.tickRate=uint16_t(replay.tickRate);
+    header.attemptCount=replay.attempts.size();
+    header.botDifficulty=uint8_t(replay.botDifficulty);
+    memset(header.padding, 0, sizeof(header.padding));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto &attempt : replay.attempts) {
+        ReplayFileAttempt record={attempt.seed, attempt.tickCount, uint32_t(attempt.runs.size()),
+                                  uint16_t(attempt.levelName.size()), 0, attempt.endHash};
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(attempt.levelName.data(), attempt.levelName.size());
+        file.write(reinterpret_cast<const char*>(attempt.runs.data()), attempt.runs.size()*sizeof(uint32_t));
+    }
+    return bool(file);
+}
+
+bool applyReplaySettings(const Replay &replay) {
+    if (replay.tickRate<30 || replay.tickRate>1000) {
+        std::cout << "Replay has an invalid tick rate." << std::endl;
+        return false;
+    }
+    if (replay.botDifficulty<0 || replay.botDifficulty>=TOTAL_DIFFICULTY) {
+        std::cout << "Replay has an invalid bot." << std::endl;
+        return false;
+    }
+    tickRate=replay.tickRate;
+    botDifficulty=BotDifficulty(replay.botDifficulty);
+    return true;
+}
+
+// FNV-1a over the raw bytes of every hitbox
+static void hashBytes(uint64_t &hash, const void *data, size_t size) {
+    const unsigned char *bytes=static_cast<const unsigned char*>(data);
+    for (size_t i=0; i<size; i++) {
+        hash^=bytes[i];
+        hash*=1099511628211ull;
+    }
+}
+
+uint64_t hashLevelState(Player &cube) {
+    uint64_t hash=14695981039346656037ull;
+    SDL_FRect hitbox=cube.getHitbox();
+    hashBytes(hash, &hitbox, sizeof(hitbox));
+    for (const auto &block : blocks) hashBytes(hash, &block.getHitbox(), sizeof(SDL_FRect));
+    for (const auto &block : pushableBlocks) {
+        hitbox=block.getHitbox();
+        hashBytes(hash, &hitbox, sizeof(hitbox));
+    }
+    for (const auto &spike : spikes) hashBytes(hash, &spike.getHitbox(), sizeof(SDL_FRect));
+    return hash;
+}
+
+uint8_t inputKeys(Player &cube) {
+    return (cube.moveLeft ? REPLAY_LEFT : 0)|(cube.moveRight ? REPLAY_RIGHT : 0)|(cube.getJumpHeld() ? REPLAY_JUMP : 0);
+}
+
+void applyInputKeys(Player &cube, uint8_t keys) {
+    cube.setInput(keys&REPLAY_LEFT, keys&REPLAY_RIGHT, keys&REPLAY_JUMP);
+}
+
+bool recordingReplay=false;
+bool playingReplay=false;
+
+static std::string recordingPath;
+static Replay replay;
+static size_t attemptIndex=0;           // Playback: next attempt to start
+static ReplayAttempt noAttempt;
+static ReplayReader reader(noAttempt);  // Playback: attempt being played
+static bool readingAttempt=false;
+static bool attemptActive=false;
+
+bool startRecording(const std::string &path) {
+    recordingPath=path;
+    replay.tickRate=tickRate;
+    replay.botDifficulty=botDifficulty;
+    replay.attempts.clear();
+    recordingReplay=saveReplay(path, replay); // Fail now rather than after the run
+    return recordingReplay;
+}
+
+bool startPlayback(const std::string &path) {
+    if (!loadReplay(path, replay) || !applyReplaySettings(replay)) return false;
+    attemptIndex=0;
+    playingReplay=!replay.attempts.empty();
+    return playingReplay;
+}
+
+unsigned int beginAttempt(int &levelIndex) {
+    attemptActive=true;
+    if (playingReplay) {
+        readingAttempt=false;
+        while (attemptIndex<replay.attempts.size()) {
+            const ReplayAttempt &attempt=replay.attempts[attemptIndex];
+            for (int i=0; i<ALL_LEVELS; i++) {
+                if (levelName[i]==attempt.levelName) {
+                    levelIndex=i;
+                    reader=ReplayReader(attempt);
+                    readingAttempt=true;
+                    return attempt.seed;
+                }
+            }
+            std::cout << "Replay level not found: " << attempt.levelName << std::endl;
+            attemptIndex++;
+        }
+        playingReplay=false;
+    }
+
+    unsigned int seed=std::random_device()();
+    if (recordingReplay) {
+        replay.attempts.emplace_back();
+        replay.attempts.back().levelName=levelName[levelIndex];
+        replay.attempts.back().seed=seed;
+    }
+    return seed;
+}
+
+// Compare the attempt being played with how it ended when recorded
+static void checkAttempt(Player &cube, uint32_t ticksLeft) {
+    const ReplayAttempt &attempt=replay.attempts[attemptIndex];
+    bool match=ticksLeft==0 && hashLevelState(cube)==attempt.endHash;
+    std::cout << "Replay attempt " << attemptIndex+1 << " (" << attempt.levelName << "): "
+              << (match ? "match" : "MISMATCH") << std::endl;
+    readingAttempt=false;
+    attemptIndex++;
+}
+
+void replayTick(Player &cube) {
+    if (!attemptActive) return;
+    if (readingAttempt) {
+        uint8_t keys;
+        if (reader.next(keys)) {
+            applyInputKeys(cube, keys);
+            return;
+        }
+        // Recording stopped in the middle of this attempt (quit), the player takes over from here
+        checkAttempt(cube, 0);
+        cube.setInput(false, false, false);
+        if (attemptIndex>=replay.attempts.size()) playingReplay=false;
+    }
+    if (recordingReplay && !playingReplay) replay.attempts.back().append(inputKeys(cube));
+}
+
+bool replayControlsInput() {
+    return readingAttempt;
+}
+
+void endAttempt(Player &cube) {
+    if (!attemptActive) return;
+    attemptActive=false;
+    if (readingAttempt) {
+        // Recorded ticks left over mean the run went differently
+        uint8_t keys;
+        uint32_t ticksLeft=0;
+        while (reader.next(keys)) ticksLeft++;
+        checkAttempt(cube, ticksLeft);
+        if (attemptIndex>=replay.attempts.size()) playingReplay=false;
+    }
+    else if (recordingReplay && !replay.attempts.empty()) {
+        replay.attempts.back().endHash=hashLevelState(cube);
+        saveReplay(recordingPath, replay);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Player;
+
+// Replay file (.dtwr): the held keys of every level attempt tick by tick, with the level name and the seed of its
+// random numbers, so the same build plays the run again exactly
+// Layout: header, then each attempt as its header, name bytes and runs back to back
+// Every tick's keys are a 3 bit mask, consecutive ticks with the same mask are stored as one run
+
+const char REPLAY_FILE_MAGIC[4]={'D', 'T', 'W', 'R'};
+const uint16_t REPLAY_FILE_VERSION=2;
+
+// Key bits
+const uint8_t REPLAY_LEFT=1;
+const uint8_t REPLAY_RIGHT=2;
+const uint8_t REPLAY_JUMP=4;
+
+// A run keeps the key mask in the top 3 bits and the tick count in the rest
+const uint32_t REPLAY_RUN_TICKS=0x1FFFFFFF;
+const int REPLAY_RUN_KEY_SHIFT=29;
+
+struct ReplayFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t tickRate;      // Replays only match at the tick rate they were recorded at
+    uint32_t attemptCount;
+    uint8_t botDifficulty;  // BotDifficulty of the Tic Tac Toe bot, it draws from the level's random numbers
+    uint8_t padding[3];
+};
+
+struct ReplayFileAttempt {
+    uint32_t seed;
+    uint32_t tickCount;
+    uint32_t runCount;
+    uint16_t nameLength;
+    uint16_t padding;
+    uint64_t endHash;       // Level state after the last tick, checked on playback
+};
+
+static_assert(sizeof(ReplayFileHeader)==16, "Replay file header must be tightly packed");
+static_assert(sizeof(ReplayFileAttempt)==24, "Replay file attempt must be tightly packed");
+
+struct ReplayAttempt {
+    std::string levelName;
+    uint32_t seed=0;
+    uint32_t tickCount=0;
+    uint64_t endHash=0;
+    std::vector<uint32_t> runs;
+
+    // Add one tick of input
+    void append(uint8_t keys);
+};
+
+struct Replay {
+    int tickRate=0;
+    int botDifficulty=0;
+    std::vector<ReplayAttempt> attempts;
+};
+
+// Reads the input of one attempt back tick by tick
+class ReplayReader {
+public:
+    explicit ReplayReader(const ReplayAttempt &attempt);
+
+    // False once every recorded tick has been read
+    bool next(uint8_t &keys);
+
+private:
+    const ReplayAttempt *attempt;
+    size_t run=0;
+    uint32_t used=0;
+};
+
+bool loadReplay(const std::string &path, Replay &replay);
+bool saveReplay(const std::string &path, const Replay &replay);
+
+// Set the tick rate and bot the replay was recorded with, false if they are out of range
+bool applyReplaySettings(const Replay &replay);
+
+// Hash of the player and every moving object, two runs that ended the same way hash the same
+uint64_t hashLevelState(Player &cube);
+
+// Held keys of the player as a key mask, and back
+uint8_t inputKeys(Player &cube);
+void applyInputKeys(Player &cube, uint8_t keys);
+
+// Recording and playback in the game window (--record, --replay)
+extern bool recordingReplay;
+extern bool playingReplay;
+bool startRecording(const std::string &path);
+bool startPlayback(const std::string &path);
+
+// A level is starting, playback picks the level of its next attempt, returns the seed to start it with
+unsigned int beginAttempt(int &levelIndex);
+
+// Before every playing tick: record the held keys, or replace them with the recorded ones
+void replayTick(Player &cube);
+
+// True while playback is feeding the player, keyboard input is ignored then
+bool replayControlsInput();
+
+// The attempt ended (death, level change, quit), recording saves the file, playback checks the result
+void endAttempt(Player &cube);
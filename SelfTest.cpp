@@ -0,0 +1,33 @@
+#include <iostream>
+#include <string>
+#include "TicTacToe.h"
+#include "Enigma.h"
+#include "Economy.h"
+#include "SelfTest.h"
+
+struct SelfTest {
+    const char *name;
+    bool (*run)();
+};
+
+static const SelfTest selfTests[]={
+    {"tic-tac-toe", testTicTacToe},
+    {"enigma", testEnigma},
+    {"economy", testEconomy},
+};
+
+int runSelfTests(const std::string &name) {
+    int ran=0, failed=0;
+    for (const auto &test : selfTests) {
+        if (!name.empty() && name!=test.name) continue;
+        bool passed=test.run();
+        std::cout << (passed ? "PASS " : "FAIL ") << test.name << std::endl;
+        ran++;
+        if (!passed) failed++;
+    }
+    if (ran==0) {
+        std::cout << "Unknown self test: " << name << std::endl;
+        return 1;
+    }
+    return failed==0 ? 0 : 1;
+}
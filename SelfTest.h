@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+// Self tests of the game engines, no window or audio device needed
+// "Die to Win" --self-test [name]
+// Each test prints what went wrong, the runner adds one PASS or FAIL line per test and nothing is timed
+
+// Run every test, or only the one named, returns a process exit code
+int runSelfTests(const std::string &name);
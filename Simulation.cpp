@@ -0,0 +1,63 @@
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "Player.h"
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "Audio.h"
+#include "Enums.h"
+#include "LevelBehavior.h"
+#include "Simulation.h"
+
+// Remember where everything is before the tick moves it
+static void savePositions(Player &cube) {
+    cube.savePosition();
+    for (auto &block : blocks) block.savePosition();
+    for (auto &block : pushableBlocks) block.savePosition();
+    for (auto &spike : spikes) spike.savePosition();
+}
+
+// The menu has no gimmicks, whatever level was played last
+static LevelBehavior menuBehavior;
+
+bool startLevel(const std::string &levelName, unsigned int seed) {
+    if (!restoreLevel(levelPath(levelName), blocks, pushableBlocks, spikes, jumpOrbs, jumpPads)) return false;
+    currentBehavior=&findLevelBehavior(levelName);
+    currentBehavior->reset(blocks);
+    resetPuzzleState();
+    levelRandom.seed(seed);
+    playMusic(MUSIC_THEME, -1);
+    return true;
+}
+
+// Add the time since start to a part of the tick and start timing the next part
+static void lap(TickTimes *times, double TickTimes::*part, Uint64 &start) {
+    if (times==nullptr) return;
+    Uint64 now=SDL_GetPerformanceCounter();
+    times->*part+=double(now-start)/SDL_GetPerformanceFrequency();
+    start=now;
+}
+
+void simulateTick(Player &cube, GameStatus &currentStatus, bool &dead, double dt, TickTimes *times) {
+    savePositions(cube);
+    advanceMusic(dt);
+    for (auto &orb : jumpOrbs) {
+        if (orb.getType()=='G') orb.updateRotation(dt);
+    }
+
+    Uint64 start=(times!=nullptr ? SDL_GetPerformanceCounter() : 0);
+    if (currentStatus==PLAYING) {
+        if (!cube.levelFreeze) cube.move(blocks, pushableBlocks, spikes, jumpOrbs, currentStatus, *currentBehavior, dt);
+        lap(times, &TickTimes::move, start);
+        cube.interact(blocks, pushableBlocks, spikes, jumpOrbs, jumpPads, *currentBehavior, dt, dead);
+        lap(times, &TickTimes::interact, start);
+        for (auto &block : pushableBlocks) {
+            if (!cube.timeStopped) block.update(blocks, cube.getHitbox(), cube.moveLeft, cube.moveRight, dead, dt);
+        }
+        lap(times, &TickTimes::pushables, start);
+    }
+    else if (currentStatus==MENU) {
+        cube.move(blocks, pushableBlocks, spikes, jumpOrbs, currentStatus, menuBehavior, dt);
+        lap(times, &TickTimes::move, start);
+    }
+}
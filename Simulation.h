@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include "Player.h"
+#include "Enums.h"
+
+// Load a level into the object vectors and reset everything the last attempt left behind, picks the level's behavior
+// seed feeds the level's random numbers (Enigma password, tic tac toe bot), same seed same run
+bool startLevel(const std::string &levelName, unsigned int seed);
+
+// Seconds spent in each part of a tick (benchmark)
+struct TickTimes {
+    double move=0;
+    double interact=0;
+    double pushables=0;
+};
+
+// Advance the level in the object vectors by one fixed tick (playing or menu), no rendering
+// times is only measured when given
+void simulateTick(Player &cube, GameStatus &currentStatus, bool &dead, double dt, TickTimes *times=nullptr);
@@ -0,0 +1,273 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <iterator>
+#include <unordered_set>
+#include <queue>
+#include <algorithm>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/wait.h>
+#endif
+#include <SDL.h>
+#include "Player.h"
+#include "LoadLevel.h"
+#include "Simulation.h"
+#include "Timestep.h"
+#include "Enums.h"
+#include "Replay.h"
+#include "TicTacToe.h"
+#include "LevelBehavior.h"
+#include "Solver.h"
+
+// Keys held for one choice, standing still first so the shortest runs come out calm
+static const uint8_t solverActions[]={0, REPLAY_LEFT, REPLAY_RIGHT, REPLAY_JUMP,
+                                      REPLAY_LEFT|REPLAY_JUMP, REPLAY_RIGHT|REPLAY_JUMP};
+static const int SOLVER_ACTIONS=sizeof(solverActions)/sizeof(solverActions[0]);
+
+// A try is the choice it made after its parent's
+struct SolverNode {
+    uint32_t parent;
+    uint8_t action;
+};
+
+// How one try ended
+struct SolverRun {
+    bool dead=false;
+    bool over=false;    // Level left some other way (menu block, credits)
+    uint32_t ticks=0;
+    uint64_t key=0;
+    float distance=0;   // From the player to the closest spike, in pixels
+};
+
+// Objects move on some levels, the same player state over a different layout is a different place
+static uint64_t layoutHash() {
+    uint64_t hash=14695981039346656037ull;
+    auto add=[&hash](const SDL_FRect &hitbox) {
+        hash^=uint64_t(int64_t(floor(hitbox.x/SOLVER_CELL))*65536+int64_t(floor(hitbox.y/SOLVER_CELL)));
+        hash*=1099511628211ull;
+    };
+    for (const auto &block : blocks) add(block.getHitbox());
+    for (const auto &block : pushableBlocks) add(block.getHitbox());
+    for (const auto &spike : spikes) add(spike.getHitbox());
+    return hash;
+}
+
+// Gap between the player and the closest spike, 0 when touching
+static float spikeDistance(const SDL_FRect &player) {
+    float closest=1e9f;
+    for (const auto &spike : spikes) {
+        const SDL_FRect &hitbox=spike.getHitbox();
+        float dx=std::max({0.0f, hitbox.x-(player.x+player.w), player.x-(hitbox.x+hitbox.w)});
+        float dy=std::max({0.0f, hitbox.y-(player.y+player.h), player.y-(hitbox.y+hitbox.h)});
+        closest=std::min(closest, std::sqrt(dx*dx+dy*dy));
+    }
+    return closest;
+}
+
+// Play a list of choices from the start of the level, recording the keys of every tick when asked
+static SolverRun playChoices(const std::string &name, unsigned int seed, const std::vector<uint8_t> &choices,
+                             ReplayAttempt *record) {
+    startLevel(name, seed);
+    Player cube;
+    GameStatus currentStatus=PLAYING;
+    SolverRun run;
+    for (uint8_t action : choices) {
+        for (int tick=0; tick<SOLVER_ACTION_TICKS; tick++) {
+            applyInputKeys(cube, solverActions[action]);
+            if (record!=nullptr) record->append(solverActions[action]);
+            simulateTick(cube, currentStatus, run.dead, tickLength());
+            run.ticks++;
+            if (run.dead || currentStatus!=PLAYING) {
+                run.over=!run.dead;
+                if (record!=nullptr) record->endHash=hashLevelState(cube);
+                return run;
+            }
+        }
+    }
+    run.key=cube.coarseState(SOLVER_CELL)^(layoutHash()*31+currentBehavior->stateHash(cube, blocks))*31;
+    run.distance=spikeDistance(cube.getHitbox());
+    if (record!=nullptr) record->endHash=hashLevelState(cube);
+    return run;
+}
+
+// Choices from the first one down to a node
+static void choicesOf(const std::vector<SolverNode> &nodes, uint32_t index, std::vector<uint8_t> &choices) {
+    choices.clear();
+    for (; index!=0; index=nodes[index].parent) choices.push_back(nodes[index].action);
+    std::reverse(choices.begin(), choices.end());
+}
+
+int runSolver(const std::string &name, const std::string &replayPath, unsigned int seed) {
+    if (!startLevel(name, seed)) {
+        std::cout << name << ": failed to load" << std::endl;
+        return SOLVER_FAILED;
+    }
+
+    // Node 0 is the start of the level, open places are ordered by choices so far plus choices to the closest spike
+    std::vector<SolverNode> nodes(1, SolverNode{0, 0});
+    std::priority_queue<std::pair<float, uint32_t>, std::vector<std::pair<float, uint32_t>>, std::greater<>> open;
+    std::unordered_set<uint64_t> seen;
+    std::vector<uint8_t> choices;
+    const size_t maxDepth=size_t((SOLVER_MAX_SECONDS+currentBehavior->waitSeconds(Player()))*tickRate/SOLVER_ACTION_TICKS);
+    const float choiceLength=float(Player::X_VELOCITY*SOLVER_ACTION_TICKS*tickLength());
+    int tries=0;
+    bool solved=false;
+    Uint64 start=SDL_GetPerformanceCounter();
+
+    SolverRun first=playChoices(name, seed, choices, nullptr);
+    seen.insert(first.key);
+    open.push({first.distance/choiceLength, 0});
+    while (!open.empty() && tries<SOLVER_MAX_TRIES && !solved) {
+        uint32_t next=open.top().second;
+        open.pop();
+        choicesOf(nodes, next, choices);
+        if (choices.size()>=maxDepth) continue;
+        choices.push_back(0);
+        for (int action=0; action<SOLVER_ACTIONS && !solved; action++) {
+            choices.back()=action;
+            SolverRun run=playChoices(name, seed, choices, nullptr);
+            tries++;
+            if (run.dead) solved=true;
+            else if (!run.over && seen.insert(run.key).second) {
+                nodes.push_back(SolverNode{next, uint8_t(action)});
+                open.push({choices.size()+run.distance/choiceLength, uint32_t(nodes.size()-1)});
+            }
+        }
+    }
+    double seconds=double(SDL_GetPerformanceCounter()-start)/SDL_GetPerformanceFrequency();
+
+    if (!solved) {
+        std::cout << name << ": UNSOLVED after " << tries << " tries, " << nodes.size() << " places (" << seconds << " s)" << std::endl;
+        return SOLVER_UNSOLVED;
+    }
+
+    // Play the answer once more for the replay, the same inputs have to die the same way
+    Replay replay;
+    replay.tickRate=tickRate;
+    replay.botDifficulty=botDifficulty;
+    replay.attempts.emplace_back();
+    ReplayAttempt &attempt=replay.attempts.back();
+    attempt.levelName=name;
+    attempt.seed=seed;
+    SolverRun run=playChoices(name, seed, choices, &attempt);
+    attempt.tickCount=run.ticks;
+    if (!run.dead) {
+        std::cout << name << ": answer didn't die when played again" << std::endl;
+        return SOLVER_FAILED;
+    }
+    if (!saveReplay(replayPath, replay)) {
+        std::cout << name << ": solved, but the replay couldn't be saved" << std::endl;
+        return SOLVER_FAILED;
+    }
+    std::cout << name << ": dies after " << run.ticks << " ticks, " << tries << " tries, " << nodes.size()
+              << " places (" << seconds << " s) -> " << replayPath << std::endl;
+    return SOLVER_SOLVED;
+}
+
+// Levels the solver found a death in when it was written (seed 1), a physics change must not lose one of these
+static const char *solvableLevels[]={"Die to Win", "Getting Over It", "Geometry Jump", "Dash", "Labyrinth", "VVVVVV",
+                                     "Tic Tac Toe", "The End"};
+
+// Exit code of a child process from what std::system returned
+static int exitCode(int status) {
+#ifdef _WIN32
+    return status;
+#else
+    return (status!=-1 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+// Create the replay directory if needed and make sure replays can be written there
+static bool prepareDirectory(const std::string &directory) {
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+    struct stat info;
+    if (stat(directory.c_str(), &info)!=0 || !(info.st_mode&S_IFDIR)) {
+        std::cout << "Replay directory can't be created: " << directory << std::endl;
+        return false;
+    }
+    std::string probePath=directory+"/.solver";
+    if (!std::ofstream(probePath).is_open()) {
+        std::cout << "Replay directory isn't writable: " << directory << std::endl;
+        return false;
+    }
+    std::remove(probePath.c_str());
+    return true;
+}
+
+// Levels handed out to the worker threads, each one runs the solver in a child process
+struct SolverJobs {
+    std::vector<std::string> commands;
+    std::vector<int> results;
+    SDL_atomic_t next;
+};
+
+static int solverWorker(void *data) {
+    SolverJobs *jobs=static_cast<SolverJobs*>(data);
+    int index;
+    while ((index=SDL_AtomicAdd(&jobs->next, 1))<int(jobs->commands.size())) {
+        jobs->results[index]=std::system(jobs->commands[index].c_str());
+    }
+    return 0;
+}
+
+int runSolverAll(const std::string &program, const std::string &directory, unsigned int seed) {
+    std::vector<std::string> names(levelName+1, levelName+ALL_LEVELS); // Skip The Hub, it has no file
+    if (!prepareDirectory(directory)) return 1;
+
+    // Known solvable levels and levels with a replay from an earlier run were solvable then, losing one of those is
+    // what a physics change must not do
+    SolverJobs jobs;
+    SDL_AtomicSet(&jobs.next, 0);
+    std::vector<bool> solvedBefore;
+    for (const auto &name : names) {
+        std::string replayPath=directory+"/"+name+".dtwr";
+        bool known=std::find(std::begin(solvableLevels), std::end(solvableLevels), name)!=std::end(solvableLevels);
+        solvedBefore.push_back(known || std::ifstream(replayPath).is_open());
+        std::string command="\""+program+"\" --solve-level \""+name+"\" \""+replayPath+"\" "+std::to_string(seed);
+#ifdef _WIN32
+        command="\""+command+"\""; // cmd /c drops the outer pair of quotes
+#endif
+        jobs.commands.push_back(command);
+    }
+    jobs.results.assign(names.size(), -1);
+
+    int workerCount=std::max(1, std::min(SDL_GetCPUCount(), int(names.size())));
+    std::cout << "Solving " << names.size() << " levels, " << workerCount << " at a time" << std::endl;
+    Uint64 start=SDL_GetPerformanceCounter();
+    std::vector<SDL_Thread*> workers;
+    for (int i=0; i<workerCount; i++) {
+        SDL_Thread *thread=SDL_CreateThread(solverWorker, "Solver", &jobs);
+        if (thread!=nullptr) workers.push_back(thread);
+    }
+    if (workers.empty()) solverWorker(&jobs);
+    for (SDL_Thread *thread : workers) SDL_WaitThread(thread, nullptr);
+    double seconds=double(SDL_GetPerformanceCounter()-start)/SDL_GetPerformanceFrequency();
+
+    int solved=0, lost=0, failed=0;
+    for (size_t i=0; i<names.size(); i++) {
+        int code=exitCode(jobs.results[i]);
+        if (code==SOLVER_SOLVED) solved++;
+        else if (code!=SOLVER_UNSOLVED) {
+            std::cout << "Failed: " << names[i] << " (exit code " << code << ")" << std::endl;
+            failed++;
+        }
+        else if (solvedBefore[i]) {
+            std::cout << "No longer solvable: " << names[i] << std::endl;
+            lost++;
+        }
+        else std::cout << "Unsolved: " << names[i] << std::endl;
+    }
+    std::cout << solved << " of " << names.size() << " levels solved (" << seconds << " s)" << std::endl;
+    return (lost==0 && failed==0) ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Level solver: a best first search over the held keys, run on the real simulation at the fixed tick, that
+// looks for a way to die (the goal of every level)
+// Each try plays its inputs from the start of the level, so it can't drift from what the game would do, and
+// tries that end in a player state (Player::coarseState), object layout and level state (LevelBehavior::stateHash)
+// already seen are dropped
+// Places closest to a spike are tried first, counting each choice as far as the player runs in one
+
+// Ticks each choice of keys is held for
+const int SOLVER_ACTION_TICKS=8;
+
+// Size of the cells positions are rounded to, in pixels
+const float SOLVER_CELL=12;
+
+// Tries before a level counts as unsolved
+const int SOLVER_MAX_TRIES=200000;
+
+// Longest run looked at, on top of the time a level takes to end on its own (LevelBehavior::waitSeconds)
+const int SOLVER_MAX_SECONDS=60;
+
+// Exit codes of --solve-level, anything but unsolved is a problem with the run rather than the level
+const int SOLVER_SOLVED=0;
+const int SOLVER_UNSOLVED=1;
+const int SOLVER_FAILED=2;  // Level didn't load, the answer didn't replay or the replay couldn't be saved
+
+// Solve one level and write the inputs that kill the player as a replay, returns one of the exit codes above
+// "Die to Win" --solve-level name replay [seed]
+int runSolver(const std::string &name, const std::string &replayPath, unsigned int seed);
+
+// Solve every level, each in its own process with as many running as there are cores, replays go to directory
+// (created if missing)
+// Fails when a level the solver is known to solve, or one with a replay there from an earlier run, can't be solved
+// anymore, or when any run fails, the replays themselves can be checked with --replay-fast
+// "Die to Win" --solve-levels [directory] [seed]
+int runSolverAll(const std::string &program, const std::string &directory, unsigned int seed);
@@ -0,0 +1,73 @@
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <SDL.h>
+#include "Texture.h"
+#include "SpriteBatch.h"
+
+extern SDL_Renderer *gRenderer;
+
+const double DEGREES_TO_RADIANS=3.14159265358979323846/180;
+
+SpriteBatch::SpriteBatch(LTexture *texture) : texture(texture) {}
+
+// Sine and cosine of an angle in degrees, exact for right angles (every tile)
+static void rotation(double angle, float &sine, float &cosine) {
+    double turns=angle/90;
+    if (turns==std::floor(turns)) {
+        static const float sines[4]={0, 1, 0, -1};
+        int quarter=((int(turns)%4)+4)%4;
+        sine=sines[quarter];
+        cosine=sines[(quarter+1)%4];
+        return;
+    }
+    double radians=angle*DEGREES_TO_RADIANS;
+    sine=float(std::sin(radians));
+    cosine=float(std::cos(radians));
+}
+
+void SpriteBatch::add(const SDL_FRect &quad, const SDL_Rect &clip, double angle, SDL_RendererFlip flip, SDL_Color color) {
+    // Corners clockwise from the top left, turned around the middle like SDL_RenderCopyExF
+    float sine, cosine;
+    rotation(angle, sine, cosine);
+    float halfW=quad.w/2, halfH=quad.h/2;
+    float centerX=quad.x+halfW, centerY=quad.y+halfH;
+    const float offsetX[4]={-halfW, halfW, halfW, -halfW};
+    const float offsetY[4]={-halfH, -halfH, halfH, halfH};
+    SDL_FPoint corner[4];
+    for (int i=0; i<4; i++) {
+        corner[i]={centerX+offsetX[i]*cosine-offsetY[i]*sine, centerY+offsetX[i]*sine+offsetY[i]*cosine};
+    }
+
+    float u0=clip.x/texture->getWidth(), u1=(clip.x+clip.w)/texture->getWidth();
+    float v0=clip.y/texture->getHeight(), v1=(clip.y+clip.h)/texture->getHeight();
+    if (flip&SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (flip&SDL_FLIP_VERTICAL) std::swap(v0, v1);
+    const SDL_FPoint texCoord[4]={{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    addQuad(corner, texCoord, color);
+}
+
+void SpriteBatch::addRect(const SDL_FRect &quad, SDL_Color color) {
+    const SDL_FPoint corner[4]={{quad.x, quad.y}, {quad.x+quad.w, quad.y}, {quad.x+quad.w, quad.y+quad.h}, {quad.x, quad.y+quad.h}};
+    const SDL_FPoint texCoord[4]={{0, 0}, {0, 0}, {0, 0}, {0, 0}};
+    addQuad(corner, texCoord, color);
+}
+
+void SpriteBatch::addQuad(const SDL_FPoint corner[4], const SDL_FPoint texCoord[4], SDL_Color color) {
+    int first=vertices.size();
+    for (int i=0; i<4; i++) vertices.push_back({corner[i], color, texCoord[i]});
+    for (int i : {0, 1, 2, 0, 2, 3}) indices.push_back(first+i);
+}
+
+void SpriteBatch::flush() {
+    if (!vertices.empty()) {
+        // Solid quads blend with the renderer's blend mode, sprites with the texture's
+        if (texture==nullptr) SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(gRenderer, (texture!=nullptr ? texture->getTexture() : nullptr),
+                           vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+    // Keep the memory, the next frame adds about as many quads
+    vertices.clear();
+    indices.clear();
+}
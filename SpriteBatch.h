@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include <SDL.h>
+
+class LTexture;
+
+// Collects the quads drawn from one sprite sheet and draws them all with one SDL_RenderGeometry call
+// A batch without a texture draws solid colored quads (tints)
+class SpriteBatch {
+public:
+    explicit SpriteBatch(LTexture *texture=nullptr);
+
+    // Add a sprite, same as LTexture::render: angle in degrees around the middle of the quad, flip before rotating
+    // color multiplies the sprite (alpha for fading text)
+    void add(const SDL_FRect &quad, const SDL_Rect &clip, double angle=0.0, SDL_RendererFlip flip=SDL_FLIP_NONE,
+             SDL_Color color={255, 255, 255, 255});
+
+    // Add a solid colored quad, only for batches without a texture
+    void addRect(const SDL_FRect &quad, SDL_Color color);
+
+    // Draw everything added since the last flush
+    void flush();
+
+private:
+    void addQuad(const SDL_FPoint corner[4], const SDL_FPoint texCoord[4], SDL_Color color);
+
+    LTexture *texture;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
@@ -0,0 +1,204 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "LevelObjs.h"
+#include "LoadLevel.h"
+#include "SurfaceIndex.h"
+
+// One object in one column, edges are computed the way a full scan would (right=x+w, bottom=y+h in float)
+struct SurfaceEntry {
+    float edge;
+    float left, right;
+    size_t index;
+};
+
+// Index of one object vector
+struct SurfaceColumns {
+    const void *source=nullptr;
+    unsigned int revision=0;
+    size_t indexedCount=0;                          // Objects after this were added since the last query
+    std::vector<std::vector<SurfaceEntry>> byTop;   // Per column, ascending top edge
+    std::vector<std::vector<SurfaceEntry>> byBottom; // Per column, ascending bottom edge
+    std::vector<SDL_FRect> filed;                   // Hitbox each object is filed under
+    std::vector<char> isFiled;                      // False for objects that are no surface (TILE_1J)
+    std::vector<char> isChanged;
+    std::vector<size_t> changed;                    // Objects that moved or switched type since the last query
+};
+static SurfaceColumns blockColumns;
+static SurfaceColumns spikeColumns;
+
+// Tile column of a position, clamped so objects outside the screen land on the border (same tiles as BlockGrid)
+static int surfaceColumn(float x) {
+    double col=floor((x+TILE_SIZE*11/18)/TILE_SIZE);
+    return col<0 ? 0 : (col>LEVEL_WIDTH-1 ? LEVEL_WIDTH-1 : int(col));
+}
+
+// The player passes through TILE_1J, it's no surface to land on
+static bool isSurface(const Block &block) {
+    return block.getType()!=TILE_1J;
+}
+static bool isSurface(const Spike&) {
+    return true;
+}
+
+static bool overlaps(float objectLeft, float objectRight, float left, float right, bool touching) {
+    return touching ? (objectLeft<=right && objectRight>=left) : (objectLeft<right && objectRight>left);
+}
+
+static bool byEdge(const SurfaceEntry &a, const SurfaceEntry &b) {
+    return a.edge<b.edge;
+}
+
+// Add an object to every column it covers where it is now, sorted in place unless the caller sorts afterwards
+template <typename T>
+static void fileObject(SurfaceColumns &columns, const std::vector<T> &objects, size_t i, bool sorted) {
+    const SDL_FRect &hitbox=objects[i].getHitbox();
+    columns.filed[i]=hitbox;
+    columns.isFiled[i]=isSurface(objects[i]);
+    if (!columns.isFiled[i]) return;
+
+    SurfaceEntry top={hitbox.y, hitbox.x, hitbox.x+hitbox.w, i};
+    SurfaceEntry bottom={hitbox.y+hitbox.h, top.left, top.right, i};
+    for (int col=surfaceColumn(top.left); col<=surfaceColumn(top.right); col++) {
+        std::vector<SurfaceEntry> &byTop=columns.byTop[col], &byBottom=columns.byBottom[col];
+        if (sorted) {
+            byTop.insert(std::upper_bound(byTop.begin(), byTop.end(), top, byEdge), top);
+            byBottom.insert(std::upper_bound(byBottom.begin(), byBottom.end(), bottom, byEdge), bottom);
+        }
+        else {
+            byTop.push_back(top);
+            byBottom.push_back(bottom);
+        }
+    }
+}
+
+// Remove an object's entries from one column, found by the edge it was filed under
+static void eraseEntry(std::vector<SurfaceEntry> &column, float edge, size_t index) {
+    SurfaceEntry key={edge, 0, 0, 0};
+    for (auto entry=std::lower_bound(column.begin(), column.end(), key, byEdge); entry!=column.end() && entry->edge==edge; ++entry) {
+        if (entry->index==index) {
+            column.erase(entry);
+            return;
+        }
+    }
+}
+
+static void unfileObject(SurfaceColumns &columns, size_t i) {
+    if (!columns.isFiled[i]) return;
+    const SDL_FRect &hitbox=columns.filed[i];
+    for (int col=surfaceColumn(hitbox.x); col<=surfaceColumn(hitbox.x+hitbox.w); col++) {
+        eraseEntry(columns.byTop[col], hitbox.y, i);
+        eraseEntry(columns.byBottom[col], hitbox.y+hitbox.h, i);
+    }
+    columns.isFiled[i]=false;
+}
+
+// Index every object after a level load, then file again whatever changed or was added since the last query
+template <typename T>
+static void prepareColumns(SurfaceColumns &columns, const std::vector<T> &objects) {
+    if (columns.source!=&objects || columns.revision!=levelRevision || objects.size()<columns.indexedCount) {
+        columns.source=&objects;
+        columns.revision=levelRevision;
+        columns.indexedCount=objects.size();
+        columns.byTop.assign(LEVEL_WIDTH, std::vector<SurfaceEntry>());
+        columns.byBottom.assign(LEVEL_WIDTH, std::vector<SurfaceEntry>());
+        columns.filed.assign(objects.size(), SDL_FRect());
+        columns.isFiled.assign(objects.size(), 0);
+        columns.isChanged.assign(objects.size(), 0);
+        columns.changed.clear();
+        for (size_t i=0; i<objects.size(); i++) fileObject(columns, objects, i, false);
+        for (int col=0; col<LEVEL_WIDTH; col++) {
+            std::stable_sort(columns.byTop[col].begin(), columns.byTop[col].end(), byEdge);
+            std::stable_sort(columns.byBottom[col].begin(), columns.byBottom[col].end(), byEdge);
+        }
+        return;
+    }
+
+    for (size_t i : columns.changed) {
+        unfileObject(columns, i);
+        fileObject(columns, objects, i, true);
+        columns.isChanged[i]=0;
+    }
+    columns.changed.clear();
+
+    if (objects.size()>columns.indexedCount) {
+        columns.filed.resize(objects.size());
+        columns.isFiled.resize(objects.size(), 0);
+        columns.isChanged.resize(objects.size(), 0);
+        for (size_t i=columns.indexedCount; i<objects.size(); i++) fileObject(columns, objects, i, true);
+        columns.indexedCount=objects.size();
+    }
+}
+
+template <typename T>
+static void markChanged(SurfaceColumns &columns, const T &object) {
+    // Objects of other vectors (level cache, level compiler) and changes before the index is built don't matter
+    if (columns.source==nullptr || columns.revision!=levelRevision) return;
+    const std::vector<T> &objects=*static_cast<const std::vector<T>*>(columns.source);
+    if (objects.empty() || &object<objects.data() || &object>=objects.data()+objects.size()) return;
+
+    size_t i=&object-objects.data();
+    if (i>=columns.indexedCount || columns.isChanged[i]) return;
+    columns.isChanged[i]=1;
+    columns.changed.push_back(i);
+}
+
+template <typename T>
+static float findCeiling(SurfaceColumns &columns, const std::vector<T> &objects, float left, float right, float y, bool touching) {
+    prepareColumns(columns, objects);
+    float closest=-INFINITY;
+    for (int col=surfaceColumn(left); col<=surfaceColumn(right); col++) {
+        // Walk up from the last bottom edge at or above y until an entry overlaps the span
+        const std::vector<SurfaceEntry> &column=columns.byBottom[col];
+        auto entry=std::upper_bound(column.begin(), column.end(), y,
+                                    [](float value, const SurfaceEntry &e) { return value<e.edge; });
+        while (entry!=column.begin()) {
+            --entry;
+            if (entry->edge<=closest) break;
+            if (overlaps(entry->left, entry->right, left, right, touching)) {
+                closest=entry->edge;
+                break;
+            }
+        }
+    }
+    return closest;
+}
+
+template <typename T>
+static float findFloor(SurfaceColumns &columns, const std::vector<T> &objects, float left, float right, float y, bool touching) {
+    prepareColumns(columns, objects);
+    float closest=INFINITY;
+    for (int col=surfaceColumn(left); col<=surfaceColumn(right); col++) {
+        // Walk down from the first top edge at or below y until an entry overlaps the span
+        const std::vector<SurfaceEntry> &column=columns.byTop[col];
+        auto entry=std::lower_bound(column.begin(), column.end(), y,
+                                    [](const SurfaceEntry &e, float value) { return e.edge<value; });
+        for (; entry!=column.end() && entry->edge<closest; ++entry) {
+            if (overlaps(entry->left, entry->right, left, right, touching)) {
+                closest=entry->edge;
+                break;
+            }
+        }
+    }
+    return closest;
+}
+
+float findBlockCeiling(const std::vector<Block> &blocks, float left, float right, float y) {
+    return findCeiling(blockColumns, blocks, left, right, y, false);
+}
+float findBlockFloor(const std::vector<Block> &blocks, float left, float right, float y) {
+    return findFloor(blockColumns, blocks, left, right, y, false);
+}
+float findSpikeCeiling(const std::vector<Spike> &spikes, float left, float right, float y) {
+    return findCeiling(spikeColumns, spikes, left, right, y, true);
+}
+float findSpikeFloor(const std::vector<Spike> &spikes, float left, float right, float y) {
+    return findFloor(spikeColumns, spikes, left, right, y, true);
+}
+
+void markSurfaceChanged(const Block &block) {
+    markChanged(blockColumns, block);
+}
+void markSurfaceChanged(const Spike &spike) {
+    markChanged(spikeColumns, spike);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include "LevelObjs.h"
+
+// Vertical surface index: when a level loads, every block (except TILE_1J, which the player passes through) and
+// every spike is listed in each level column it covers, sorted by its top edge and by its bottom edge.
+// The closest surface above or below a span is then a binary search per column instead of a scan of the level.
+// Objects that move or switch type tell the index, the next query takes them out of their old columns and files
+// them where they are now, objects added during play are filed the same way.
+
+// Bottom edge of the closest block above y (bottom<=y) that overlaps left..right, edges touching sideways don't count
+// -INFINITY if there is none
+float findBlockCeiling(const std::vector<Block> &blocks, float left, float right, float y);
+
+// Top edge of the closest block below y (top>=y) that overlaps left..right, INFINITY if there is none
+float findBlockFloor(const std::vector<Block> &blocks, float left, float right, float y);
+
+// The same for spikes, edges touching sideways count
+float findSpikeCeiling(const std::vector<Spike> &spikes, float left, float right, float y);
+float findSpikeFloor(const std::vector<Spike> &spikes, float left, float right, float y);
+
+// Tell the index an object is no longer where (or what) it was when it was filed
+void markSurfaceChanged(const Block &block);
+void markSurfaceChanged(const Spike &spike);
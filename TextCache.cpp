@@ -0,0 +1,117 @@
+#include <string>
+#include <functional>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Texture.h"
+#include "TextCache.h"
+
+static Uint32 packColor(SDL_Color color) {
+    return Uint32(color.r)<<24 | Uint32(color.g)<<16 | Uint32(color.b)<<8 | color.a;
+}
+
+size_t TextCache::KeyHash::operator()(const Key &key) const {
+    size_t hash=std::hash<std::string>()(key.text);
+    hash^=std::hash<const void*>()(key.font)+0x9e3779b9+(hash<<6)+(hash>>2);
+    hash^=std::hash<Uint32>()(key.color)+0x9e3779b9+(hash<<6)+(hash>>2);
+    return hash;
+}
+
+TextCache::TextCache(size_t budget) : budget(budget) {}
+
+TextHandle TextCache::acquire(const std::string &text, TTF_Font *font, SDL_Color color) {
+    Key key={text, font, packColor(color)};
+    auto found=lookup.find(key);
+    if (found!=lookup.end()) {
+        stats.hits++;
+        int index=found->second;
+        unlink(index);
+        pushFront(index);
+        return {index, entries[index].generation};
+    }
+
+    stats.misses++;
+    int index;
+    if (!freeSlots.empty()) {
+        index=freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index=entries.size();
+        entries.emplace_back();
+    }
+    Entry &entry=entries[index];
+    if (!entry.texture.loadFromRenderedText(text, color, font)) {
+        freeSlots.push_back(index);
+        return {};
+    }
+    entry.key=key;
+    entry.bytes=size_t(entry.texture.getWidth())*size_t(entry.texture.getHeight())*4;
+    lookup.emplace(std::move(key), index);
+    pushFront(index);
+    stats.bytesResident+=entry.bytes;
+    stats.entries++;
+    return {index, entry.generation};
+}
+
+LTexture *TextCache::resolve(TextHandle handle) {
+    if (handle.index<0 || handle.index>=int(entries.size()) || entries[handle.index].generation!=handle.generation) return nullptr;
+    return &entries[handle.index].texture;
+}
+
+LTexture &TextCache::get(const std::string &text, TTF_Font *font, SDL_Color color) {
+    LTexture *texture=resolve(acquire(text, font, color));
+    return texture!=nullptr ? *texture : empty;
+}
+
+void TextCache::trim() {
+    // Always keep the newest texture, even one over budget on its own would otherwise be rasterized every frame
+    while (stats.bytesResident>budget && tail!=head) {
+        evict(tail);
+    }
+}
+
+void TextCache::clear() {
+    while (head!=-1) {
+        evict(head);
+    }
+}
+
+void TextCache::setBudget(size_t newBudget) {
+    budget=newBudget;
+}
+
+const TextCacheStats &TextCache::getStats() const {
+    return stats;
+}
+
+void TextCache::unlink(int index) {
+    Entry &entry=entries[index];
+    if (entry.prev!=-1) entries[entry.prev].next=entry.next;
+    else head=entry.next;
+    if (entry.next!=-1) entries[entry.next].prev=entry.prev;
+    else tail=entry.prev;
+    entry.prev=entry.next=-1;
+}
+
+void TextCache::pushFront(int index) {
+    Entry &entry=entries[index];
+    entry.prev=-1;
+    entry.next=head;
+    if (head!=-1) entries[head].prev=index;
+    head=index;
+    if (tail==-1) tail=index;
+}
+
+void TextCache::evict(int index) {
+    Entry &entry=entries[index];
+    unlink(index);
+    lookup.erase(entry.key);
+    entry.texture.free();
+    entry.key.text.clear();
+    entry.generation++; // Old handles to this slot stop resolving
+    stats.bytesResident-=entry.bytes;
+    stats.entries--;
+    stats.evictions++;
+    entry.bytes=0;
+    freeSlots.push_back(index);
+}
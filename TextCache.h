@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Texture.h"
+
+// Memory the cached text may use, estimated at 4 bytes per pixel
+const size_t TEXT_CACHE_BUDGET=32*1024*1024;
+
+// Refers to one cached texture, goes stale once that texture is evicted
+struct TextHandle {
+    int index=-1;
+    unsigned int generation=0;
+};
+
+struct TextCacheStats {
+    unsigned long long hits=0;
+    unsigned long long misses=0; // Every miss rasterized a string
+    unsigned long long evictions=0;
+    size_t bytesResident=0;
+    int entries=0;
+};
+
+// Rendered text textures keyed by string, font and color
+// Least recently used textures are freed when the cache is over budget, but only in trim(),
+// so every texture handed out during a frame stays valid until the frame is presented
+class TextCache {
+public:
+    explicit TextCache(size_t budget=TEXT_CACHE_BUDGET);
+    TextCache(const TextCache&)=delete;
+    TextCache &operator=(const TextCache&)=delete;
+
+    // Find the texture for a string or rasterize it, invalid handle (index -1) if rendering failed
+    TextHandle acquire(const std::string &text, TTF_Font *font, SDL_Color color);
+
+    // Texture of a handle, nullptr once evicted
+    LTexture *resolve(TextHandle handle);
+
+    // acquire + resolve, an empty texture if rendering failed so callers can always draw it
+    LTexture &get(const std::string &text, TTF_Font *font, SDL_Color color);
+
+    // Evict least recently used textures until the cache fits its budget, once per frame after presenting
+    void trim();
+
+    // Free every texture, before the renderer is destroyed
+    void clear();
+
+    void setBudget(size_t newBudget);
+    const TextCacheStats &getStats() const;
+
+private:
+    struct Key {
+        std::string text;
+        TTF_Font *font=nullptr;
+        Uint32 color=0;
+        bool operator==(const Key &other) const {
+            return font==other.font && color==other.color && text==other.text;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+    struct Entry {
+        LTexture texture;
+        Key key;
+        size_t bytes=0;
+        unsigned int generation=0;
+        int prev=-1, next=-1; // Recency list, head is the most recently used
+    };
+
+    std::deque<Entry> entries; // Deque so textures never move when the cache grows
+    std::vector<int> freeSlots;
+    std::unordered_map<Key, int, KeyHash> lookup;
+    int head=-1, tail=-1;
+    size_t budget;
+    TextCacheStats stats;
+    LTexture empty;
+
+    void unlink(int index);
+    void pushFront(int index);
+    void evict(int index);
+};
+
+extern TextCache textCache;
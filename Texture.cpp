@@ -4,6 +4,7 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include "Texture.h"
+#include "Profiler.h"
 using namespace std;
 
 extern SDL_Renderer *gRenderer;
@@ -44,8 +45,23 @@ bool LTexture::loadFromFile(string path) {
     return mTexture!=nullptr;
 }
 
+// Load texture from a surface
+bool LTexture::loadFromSurface(SDL_Surface *surface) {
+    free();
+    mTexture=SDL_CreateTextureFromSurface(gRenderer, surface);
+    if (mTexture==nullptr) {
+        cout << "Unable to create texture from surface. " << SDL_GetError() << endl;
+    }
+    else {
+        mWidth=surface->w;
+        mHeight=surface->h;
+    }
+    return mTexture!=nullptr;
+}
+
 // Load texture from text
 bool LTexture::loadFromRenderedText(string textureText, SDL_Color textColor, TTF_Font *font) {
+    PROFILE_SPAN_DETAIL("renderText", textureText.c_str());
     free();
     SDL_Surface *textSurface=TTF_RenderText_Solid(font, textureText.c_str(), textColor);
     if (textSurface==nullptr) {
@@ -113,3 +129,8 @@ float LTexture::getWidth() {
 float LTexture::getHeight() {
     return mHeight;
 }
+
+// Get the SDL texture
+SDL_Texture *LTexture::getTexture() {
+    return mTexture;
+}
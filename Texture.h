@@ -15,6 +15,9 @@ public:
     // Load texture from image
     bool loadFromFile(std::string path);
 
+    // Load texture from a surface, the surface still belongs to the caller
+    bool loadFromSurface(SDL_Surface *surface);
+
     // Load texture from text
     bool loadFromRenderedText(std::string textureText, SDL_Color textColor, TTF_Font *font);
 
@@ -41,6 +44,9 @@ public:
     float getWidth();
     float getHeight();
 
+    // Get the SDL texture, for drawing it in a batch
+    SDL_Texture *getTexture();
+
 private:
     // Texture
     SDL_Texture *mTexture;
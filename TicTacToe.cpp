@@ -0,0 +1,157 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include "TicTacToe.h"
+
+BotDifficulty botDifficulty=BOT_RANDOM;
+
+static const char *difficultyName[TOTAL_DIFFICULTY]={"random", "easy", "hard", "perfect"};
+
+bool TicTacToe::play(int cell, bool isX) {
+    if (!isEmpty(cell)) return false;
+    (isX ? x : o)|=uint16_t(1<<cell);
+    return true;
+}
+
+TicTacToeResult TicTacToe::result() const {
+    if (hasLine(x)) return TTT_X_WINS;
+    if (hasLine(o)) return TTT_O_WINS;
+    if ((x|o)==TTT_FULL_BOARD) return TTT_DRAW;
+    return TTT_PLAYING;
+}
+
+// Transposition table indexed by both boards, every reachable position fits
+static const int8_t UNSOLVED=-128;
+static int8_t solved[1<<18];
+static bool tableReady=false;
+
+static int countCells(uint16_t board) {
+    int count=0;
+    for (; board!=0; board&=board-1) count++;
+    return count;
+}
+
+int solveTicTacToe(uint16_t mover, uint16_t opponent) {
+    if (!tableReady) {
+        for (auto &score : solved) score=UNSOLVED;
+        tableReady=true;
+    }
+    int8_t &entry=solved[mover|(opponent<<9)];
+    if (entry!=UNSOLVED) return entry;
+
+    uint16_t empty=~(mover|opponent)&TTT_FULL_BOARD;
+    int best;
+    if (hasLine(opponent)) best=-(1+countCells(empty)); // Lost, sooner is worse
+    else if (empty==0) best=0;
+    else {
+        best=-100;
+        for (uint16_t moves=empty; moves!=0; moves&=moves-1) {
+            uint16_t move=moves&-moves;
+            int score=-solveTicTacToe(opponent, mover|move);
+            if (score>best) best=score;
+        }
+    }
+    entry=int8_t(best);
+    return best;
+}
+
+// Index of the nth set bit, counting from cell 0
+static int nthCell(uint16_t board, int n) {
+    for (int cell=0; cell<9; cell++) {
+        if ((board>>cell)&1) {
+            if (n==0) return cell;
+            n--;
+        }
+    }
+    return -1;
+}
+
+int pickBotMove(const TicTacToe &game, BotDifficulty difficulty, std::mt19937 &random) {
+    uint16_t empty=game.empty();
+    if (empty==0) return -1;
+
+    bool playBest=(difficulty==BOT_PERFECT ||
+                   (difficulty==BOT_EASY && random()%3==0) ||
+                   (difficulty==BOT_HARD && random()%3!=0));
+    if (!playBest) return nthCell(empty, random()%countCells(empty));
+
+    // Any of the best moves, so the bot doesn't play the same game every time
+    uint16_t bestMoves=0;
+    int bestScore=-100;
+    for (int cell=0; cell<9; cell++) {
+        if (!((empty>>cell)&1)) continue;
+        int score=-solveTicTacToe(game.x, game.o|uint16_t(1<<cell));
+        if (score>bestScore) {
+            bestScore=score;
+            bestMoves=0;
+        }
+        if (score==bestScore) bestMoves|=uint16_t(1<<cell);
+    }
+    return nthCell(bestMoves, random()%countCells(bestMoves));
+}
+
+bool parseBotDifficulty(const std::string &name, BotDifficulty &difficulty) {
+    for (int i=0; i<TOTAL_DIFFICULTY; i++) {
+        if (name==difficultyName[i]) {
+            difficulty=BotDifficulty(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every game from here with the player trying each cell and the bot trying each of its best replies
+static void playAllGames(TicTacToe game, long long &games, long long &lost, long long &drawn) {
+    for (int cell=0; cell<9; cell++) {
+        TicTacToe next=game;
+        if (!next.play(cell, true)) continue;
+        if (next.result()!=TTT_PLAYING) {
+            games++;
+            if (next.result()==TTT_X_WINS) lost++;
+            else drawn++;
+            continue;
+        }
+        int bestScore=-100;
+        for (int reply=0; reply<9; reply++) {
+            if (next.isEmpty(reply)) bestScore=std::max(bestScore, -solveTicTacToe(next.x, next.o|uint16_t(1<<reply)));
+        }
+        for (int reply=0; reply<9; reply++) {
+            if (!next.isEmpty(reply) || -solveTicTacToe(next.x, next.o|uint16_t(1<<reply))!=bestScore) continue;
+            TicTacToe answered=next;
+            answered.play(reply, false);
+            if (answered.result()==TTT_PLAYING) playAllGames(answered, games, lost, drawn);
+            else {
+                games++;
+                if (answered.result()==TTT_DRAW) drawn++;
+            }
+        }
+    }
+}
+
+bool testTicTacToe() {
+    long long games=0, lost=0, drawn=0;
+    playAllGames(TicTacToe(), games, lost, drawn);
+    if (lost>0) {
+        std::cout << "Perfect bot lost " << lost << " of " << games << " games" << std::endl;
+        return false;
+    }
+    if (solveTicTacToe(0, 0)!=0) {
+        std::cout << "Empty board doesn't solve to a draw" << std::endl;
+        return false;
+    }
+
+    // Every legal position the random bot reaches gets a legal perfect move
+    std::mt19937 random(1);
+    for (int i=0; i<100000; i++) {
+        TicTacToe game;
+        int marks=random()%8;
+        for (int m=0; m<marks && game.result()==TTT_PLAYING; m++) {
+            game.play(pickBotMove(game, BOT_RANDOM, random), m%2==0);
+        }
+        if (game.result()==TTT_PLAYING && !game.isEmpty(pickBotMove(game, BOT_PERFECT, random))) {
+            std::cout << "Perfect bot picked a taken cell" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
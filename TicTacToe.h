@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <random>
+
+// Tic tac toe on two 9-bit boards, one per side, cell i is row i/3 and column i%3
+// The player is X and moves first, the bot is O
+
+const uint16_t TTT_FULL_BOARD=0x1FF;
+
+// Rows, columns and diagonals
+const uint16_t TTT_WIN_MASKS[8]={0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054};
+
+enum TicTacToeResult {
+    TTT_PLAYING,
+    TTT_X_WINS,
+    TTT_O_WINS,
+    TTT_DRAW
+};
+
+// How the bot picks its move (--bot random|easy|hard|perfect)
+enum BotDifficulty {
+    BOT_RANDOM,     // Any empty cell, the level is tuned for this one
+    BOT_EASY,       // Best move a third of the time, otherwise random
+    BOT_HARD,       // Best move two thirds of the time
+    BOT_PERFECT,    // Always a best move, can't be beaten
+    TOTAL_DIFFICULTY
+};
+extern BotDifficulty botDifficulty;
+
+struct TicTacToe {
+    uint16_t x=0, o=0;
+
+    uint16_t empty() const { return ~(x|o)&TTT_FULL_BOARD; }
+    bool isEmpty(int cell) const { return (empty()>>cell)&1; }
+    void reset() { x=0; o=0; }
+
+    // Put a mark on an empty cell, false if it's taken
+    bool play(int cell, bool isX);
+
+    TicTacToeResult result() const;
+};
+
+// Check if a board has three in a row
+inline bool hasLine(uint16_t board) {
+    for (uint16_t mask : TTT_WIN_MASKS) {
+        if ((board&mask)==mask) return true;
+    }
+    return false;
+}
+
+// Value of a position for the side to move with perfect play from both sides (negamax, memoized)
+// Positive wins, negative loses, 0 draws, a win with more empty cells left scores higher
+int solveTicTacToe(uint16_t mover, uint16_t opponent);
+
+// Cell the bot plays next, -1 if the board is full
+// BOT_RANDOM draws exactly one number from random, like the bot always did
+int pickBotMove(const TicTacToe &game, BotDifficulty difficulty, std::mt19937 &random);
+
+// Parse a --bot value, false if it isn't one
+bool parseBotDifficulty(const std::string &name, BotDifficulty &difficulty);
+
+// Self test: play every game the player can try against the perfect bot, false if the bot loses one
+bool testTicTacToe();
@@ -0,0 +1,136 @@
+#include <string>
+#include <unordered_map>
+#include <SDL.h>
+#include "TileTypes.h"
+
+// Same order as the TileType enum
+const TileInfo tileInfo[TILE_COUNT]={
+    {"", 0, 0, SDL_FLIP_NONE, 0},
+
+    // Blocks
+    {"1C0", 0, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1C1", 0, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1C2", 0, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1C3", 0, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1WH", 1, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1WV", 1, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1WVI", 1, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1TL", 2, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1TU", 2, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1TR", 2, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1TD", 2, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1PU", 3, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1PR", 3, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1PD", 3, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1PL", 3, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1E", 4, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_TIC_TAC_TOE_CELL},
+    {"1B", 5, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_TIC_TAC_TOE_CELL},
+    {"1BI", 5, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE|FLAG_ENIGMA_DISPLAY},
+    {"1BG", 5, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_COLORED|FLAG_ENIGMA_DISPLAY},
+    {"1BO", 5, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_COLORED|FLAG_ENIGMA_DISPLAY},
+    {"1BY", 5, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_COLORED},
+    {"1I1", 6, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1I2", 7, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE|FLAG_CLICKER_UPGRADE},
+    {"1I3", 8, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE|FLAG_CLICKER_UPGRADE},
+    {"1I4", 9, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE|FLAG_CLICKER_UPGRADE},
+    {"1IP", 10, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1S", 11, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1P", 12, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1C", 13, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1IN", 14, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1BB", 15, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1SA", 16, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1MV", 17, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1XM", 18, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1XI", 19, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1X", 19, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_TIC_TAC_TOE_CELL},
+    {"1O", 20, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_TIC_TAC_TOE_CELL},
+    {"1R", 21, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1ZA", 22, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID|FLAG_INTERACTABLE},
+    {"1K0", 23, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1K1", 23, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1K2", 23, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1K3", 23, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1LU", 24, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1LR", 24, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1LD", 24, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1LL", 24, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"1JL", 28, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_JUMP_THROUGH},
+    {"1JR", 28, 0, SDL_FLIP_HORIZONTAL, FLAG_BLOCK|FLAG_JUMP_THROUGH},
+    {"1J", 29, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_JUMP_THROUGH},
+    {"1Y", 30, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+
+    // Platform tip[25] with spike
+    {"3AU", 25, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3AR", 25, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3AD", 25, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3AL", 25, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+
+    // Platform tip[25] with spike, mirrored
+    {"3AUM", 25, 0, SDL_FLIP_HORIZONTAL, FLAG_BLOCK|FLAG_SOLID},
+    {"3ARM", 25, 90, SDL_FLIP_HORIZONTAL, FLAG_BLOCK|FLAG_SOLID},
+    {"3ADM", 25, 180, SDL_FLIP_HORIZONTAL, FLAG_BLOCK|FLAG_SOLID},
+    {"3ALM", 25, 270, SDL_FLIP_HORIZONTAL, FLAG_BLOCK|FLAG_SOLID},
+
+    // Normal platform[26] with spike
+    {"3CU", 26, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3CR", 26, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3CD", 26, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3CL", 26, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+
+    // Normal platform[27] with big spike
+    {"3EU", 27, 0, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3ER", 27, 90, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3ED", 27, 180, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+    {"3EL", 27, 270, SDL_FLIP_NONE, FLAG_BLOCK|FLAG_SOLID},
+
+    // Spikes, spike platforms are blocks (number 3 in front)
+
+    // Platform tip with spike[0]
+    {"2AU", 0, 0, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2AR", 0, 90, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2AD", 0, 180, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2AL", 0, 270, SDL_FLIP_NONE, FLAG_SPIKE},
+
+    // Platform tip with spike[0], mirrored
+    {"2AUM", 0, 0, SDL_FLIP_HORIZONTAL, FLAG_SPIKE},
+    {"2ARM", 0, 90, SDL_FLIP_HORIZONTAL, FLAG_SPIKE},
+    {"2ADM", 0, 180, SDL_FLIP_HORIZONTAL, FLAG_SPIKE},
+    {"2ALM", 0, 270, SDL_FLIP_HORIZONTAL, FLAG_SPIKE},
+
+    // Normal platform with spike[1]
+    {"2CU", 1, 0, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2CR", 1, 90, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2CD", 1, 180, SDL_FLIP_NONE, FLAG_SPIKE},
+    {"2CL", 1, 270, SDL_FLIP_NONE, FLAG_SPIKE},
+
+    // Normal platform with big spike[2]
+    {"2EU", 2, 0, SDL_FLIP_NONE, FLAG_SPIKE|FLAG_BIG_SPIKE},
+    {"2ER", 2, 90, SDL_FLIP_NONE, FLAG_SPIKE|FLAG_BIG_SPIKE},
+    {"2ED", 2, 180, SDL_FLIP_NONE, FLAG_SPIKE|FLAG_BIG_SPIKE},
+    {"2EL", 2, 270, SDL_FLIP_NONE, FLAG_SPIKE|FLAG_BIG_SPIKE},
+
+    // Jump pads
+    {"JU", 0, 0, SDL_FLIP_NONE, FLAG_PAD|FLAG_YELLOW_PAD},
+    {"JD", 0, 180, SDL_FLIP_NONE, FLAG_PAD|FLAG_YELLOW_PAD},
+    {"SU", 1, 0, SDL_FLIP_NONE, FLAG_PAD|FLAG_SPIDER_PAD},
+    {"SR", 1, 90, SDL_FLIP_NONE, FLAG_PAD|FLAG_SPIDER_PAD},
+    {"SD", 1, 180, SDL_FLIP_NONE, FLAG_PAD|FLAG_SPIDER_PAD},
+    {"SL", 1, 270, SDL_FLIP_NONE, FLAG_PAD|FLAG_SPIDER_PAD},
+    {"PU", 2, 0, SDL_FLIP_NONE, FLAG_PAD|FLAG_PINK_PAD},
+    {"PD", 2, 180, SDL_FLIP_NONE, FLAG_PAD|FLAG_PINK_PAD}
+};
+
+// Find the tile type of a level file token
+TileType findTileType(const std::string &name) {
+    static const std::unordered_map<std::string, TileType> lookup=[] {
+        std::unordered_map<std::string, TileType> types;
+        for (int i=1; i<TILE_COUNT; i++) {
+            types[tileInfo[i].name]=TileType(i);
+        }
+        return types;
+    }();
+
+    auto it=lookup.find(name);
+    return it!=lookup.end() ? it->second : TILE_NONE;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <SDL.h>
+
+// Every block, spike and jump pad token that can appear in a level file, resolved once when the level loads
+enum TileType : uint8_t {
+    TILE_NONE=0,
+
+    // Blocks
+    TILE_1C0,       // Top left level corner
+    TILE_1C1,       // Top right level corner
+    TILE_1C2,       // Bottom right level corner
+    TILE_1C3,       // Bottom left level corner
+    TILE_1WH,       // Horizontal wall
+    TILE_1WV,       // Vertical wall
+    TILE_1WVI,      // Vertical wall (interactable)
+    TILE_1TL,       // T-block left
+    TILE_1TU,       // T-block up
+    TILE_1TR,       // T-block right
+    TILE_1TD,       // T-block down
+    TILE_1PU,       // Platform tip up
+    TILE_1PR,       // Platform tip right
+    TILE_1PD,       // Platform tip down
+    TILE_1PL,       // Platform tip left
+    TILE_1E,        // No border block
+    TILE_1B,        // All border block
+    TILE_1BI,       // All border block (interactable)
+    TILE_1BG,       // All border block (green)
+    TILE_1BO,       // All border block (orange)
+    TILE_1BY,       // All border block (dio)
+    TILE_1I1,       // Idle tycoon block 1 - misc upgrade
+    TILE_1I2,       // Idle tycoon block 2 - lower the point block
+    TILE_1I3,       // Idle tycoon block 3 - point upgrade
+    TILE_1I4,       // Idle tycoon block 4 - passive income upgrade
+    TILE_1IP,       // Idle tycoon - point block
+    TILE_1S,        // Menu block 1 - settings
+    TILE_1P,        // Menu block 2 - start
+    TILE_1C,        // Menu block 3 - credits
+    TILE_1IN,       // Password puzzle - check solution
+    TILE_1BB,       // Pool puzzle - add water
+    TILE_1SA,       // Time puzzle - stop time
+    TILE_1MV,       // Pushable block
+    TILE_1XM,       // Tic-tac-toe puzzle - move X to next position
+    TILE_1XI,       // Tic-tac-toe puzzle - X block (interactable)
+    TILE_1X,        // Tic-tac-toe puzzle - X block
+    TILE_1O,        // Tic-tac-toe puzzle - O block
+    TILE_1R,        // Reset puzzle
+    TILE_1ZA,       // Electricity puzzle - deplete
+    TILE_1K0,       // Top left corner block
+    TILE_1K1,       // Top right corner block
+    TILE_1K2,       // Bottom right corner block
+    TILE_1K3,       // Bottom left corner block
+    TILE_1LU,       // Line block up
+    TILE_1LR,       // Line block right
+    TILE_1LD,       // Line block down
+    TILE_1LL,       // Line block left
+    TILE_1JL,       // Jump-through platform attached to left wall
+    TILE_1JR,       // Jump-through platform attached to right wall
+    TILE_1J,        // Jump-through platform in the air
+    TILE_1Y,        // Invisible block
+
+    // Platform tip[25] with spike
+    TILE_3AU,       // Facing up
+    TILE_3AR,       // Facing right
+    TILE_3AD,       // Facing down
+    TILE_3AL,       // Facing left
+
+    // Platform tip[25] with spike, mirrored
+    TILE_3AUM,      // Facing up
+    TILE_3ARM,      // Facing right
+    TILE_3ADM,      // Facing down
+    TILE_3ALM,      // Facing left
+
+    // Normal platform[26] with spike
+    TILE_3CU,       // Facing up
+    TILE_3CR,       // Facing right
+    TILE_3CD,       // Facing down
+    TILE_3CL,       // Facing left
+
+    // Normal platform[27] with big spike
+    TILE_3EU,       // Facing up
+    TILE_3ER,       // Facing right
+    TILE_3ED,       // Facing down
+    TILE_3EL,       // Facing left
+
+    // Spikes, spike platforms are blocks (number 3 in front)
+
+    // Platform tip with spike[0]
+    TILE_2AU,       // Facing up
+    TILE_2AR,       // Facing right
+    TILE_2AD,       // Facing down
+    TILE_2AL,       // Facing left
+
+    // Platform tip with spike[0], mirrored
+    TILE_2AUM,      // Facing up
+    TILE_2ARM,      // Facing right
+    TILE_2ADM,      // Facing down
+    TILE_2ALM,      // Facing left
+
+    // Normal platform with spike[1]
+    TILE_2CU,       // Facing up
+    TILE_2CR,       // Facing right
+    TILE_2CD,       // Facing down
+    TILE_2CL,       // Facing left
+
+    // Normal platform with big spike[2]
+    TILE_2EU,       // Facing up
+    TILE_2ER,       // Facing right
+    TILE_2ED,       // Facing down
+    TILE_2EL,       // Facing left
+
+    // Jump pads
+    TILE_JU,        // Yellow pad up
+    TILE_JD,        // Yellow pad down
+    TILE_SU,        // Spider pad up
+    TILE_SR,        // Spider pad right
+    TILE_SD,        // Spider pad down
+    TILE_SL,        // Spider pad left
+    TILE_PU,        // Pink pad up
+    TILE_PD,        // Pink pad down
+
+    TILE_COUNT
+};
+
+// Properties of a tile type, checked with a bit test instead of comparing type names
+enum TileFlag : uint32_t {
+    FLAG_BLOCK=1<<0,
+    FLAG_SPIKE=1<<1,
+    FLAG_PAD=1<<2,
+
+    // Block collision
+    FLAG_SOLID=1<<3,                // Collides from every side
+    FLAG_JUMP_THROUGH=1<<4,         // Only collides when landing on top
+
+    // Block behaviour
+    FLAG_INTERACTABLE=1<<5,         // Does something when the player hits it
+    FLAG_COLORED=1<<6,              // Drawn with a colored overlay
+
+    // Level specific roles
+    FLAG_TIC_TAC_TOE_CELL=1<<7,     // Tic Tac Toe board tile
+    FLAG_ENIGMA_DISPLAY=1<<8,       // Enigma block showing a digit
+    FLAG_CLICKER_UPGRADE=1<<9,      // Cookies upgrade with a price tag
+
+    // Spike shape
+    FLAG_BIG_SPIKE=1<<10,
+
+    // Jump pad kind
+    FLAG_YELLOW_PAD=1<<11,
+    FLAG_SPIDER_PAD=1<<12,
+    FLAG_PINK_PAD=1<<13
+};
+
+// Everything known about a tile type
+struct TileInfo {
+    const char *name;           // Token used in level files
+    int clipIndex;              // Index into the block, spike or pad clips
+    double rotation;
+    SDL_RendererFlip mirrored;
+    uint32_t flags;
+};
+extern const TileInfo tileInfo[TILE_COUNT];
+
+// Find the tile type of a level file token, TILE_NONE if unknown
+TileType findTileType(const std::string &name);
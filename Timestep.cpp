@@ -0,0 +1,51 @@
+#include <SDL.h>
+#include "Timestep.h"
+
+int tickRate=DEFAULT_TICK_RATE;
+
+static Uint64 lastCounter=0;
+static double accumulator=0;
+static double dropped=0;
+
+double tickLength() {
+    return 1.0/tickRate;
+}
+
+void resetTimestep() {
+    lastCounter=SDL_GetPerformanceCounter();
+    accumulator=0;
+    dropped=0;
+}
+
+double beginFrame() {
+    Uint64 now=SDL_GetPerformanceCounter();
+    double frameTime=(lastCounter==0 ? 0 : double(now-lastCounter)/SDL_GetPerformanceFrequency());
+    lastCounter=now;
+
+    // Bounded work per frame, a long frame is not caught up
+    dropped=0;
+    if (frameTime>MAX_FRAME_TIME) {
+        dropped=frameTime-MAX_FRAME_TIME;
+        frameTime=MAX_FRAME_TIME;
+    }
+    accumulator+=frameTime;
+    if (accumulator>MAX_FRAME_TIME) {
+        dropped+=accumulator-MAX_FRAME_TIME;
+        accumulator=MAX_FRAME_TIME;
+    }
+    return frameTime;
+}
+
+double droppedTime() {
+    return dropped;
+}
+
+bool nextTick() {
+    if (accumulator<tickLength()) return false;
+    accumulator-=tickLength();
+    return true;
+}
+
+double tickAlpha() {
+    return accumulator/tickLength();
+}
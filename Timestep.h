@@ -0,0 +1,30 @@
+#pragma once
+
+// Fixed timestep: the simulation always advances by 1/tickRate seconds no matter the refresh rate,
+// each frame runs as many ticks as real time allows and rendering interpolates between the last two
+
+const int DEFAULT_TICK_RATE=240;
+
+// Longest stretch of real time simulated in one frame, anything over it (hitch, window drag) is dropped
+const double MAX_FRAME_TIME=0.25;
+
+// Ticks per second (--tick-rate)
+extern int tickRate;
+
+// Seconds per tick
+double tickLength();
+
+// Start counting from now and forget time not simulated yet or dropped (after a pause or a load)
+void resetTimestep();
+
+// Measure the frame and add it to the time to simulate, returns the frame time (for cosmetic animation)
+double beginFrame();
+
+// Real time the last beginFrame dropped instead of simulating
+double droppedTime();
+
+// Take one tick from the time to simulate, false when less than a tick is left
+bool nextTick();
+
+// How far the frame is between the last tick and the next one, 0 to 1
+double tickAlpha();
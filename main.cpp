@@ -2,7 +2,9 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
+#include <cstdio>
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
@@ -13,6 +15,21 @@
 #include "Enums.h"
 #include "LoadLevel.h"
 #include "Rendering.h"
+#include "LevelFormat.h"
+#include "Simulation.h"
+#include "LevelBehavior.h"
+#include "Timestep.h"
+#include "Audio.h"
+#include "Headless.h"
+#include "Solver.h"
+#include "SelfTest.h"
+#include "Replay.h"
+#include "Benchmark.h"
+#include "GlyphAtlas.h"
+#include "TextCache.h"
+#include "AssetLoader.h"
+#include "FramePacer.h"
+#include "Profiler.h"
 using namespace std;
 
 // Window sizes
@@ -31,12 +48,17 @@ TTF_Font *gSmallFont=nullptr;
 TTF_Font *gMediumFont=nullptr;
 TTF_Font *gLargeFont=nullptr;
 TTF_Font *gXtraFont=nullptr;
+
+// Text drawn every frame, one atlas per font
+GlyphAtlas tinyText;
+GlyphAtlas smallText;
+GlyphAtlas mediumText;
+GlyphAtlas largeText;
+GlyphAtlas xtraText;
 SDL_Color textColor={255, 255, 255};
 
 // Textures
-LTexture winMsgTexture;
-LTexture gameTitleTexture;
-LTexture instructionTexture[100];
+TextCache textCache;
 
 LTexture cubeTexture;
 LTexture blockSheetTexture;
@@ -72,6 +94,8 @@ Mix_Music *fnafSong=nullptr;
 Mix_Music *jojoSong=nullptr;
 Mix_Chunk *deathSound=nullptr;
 
+AssetLoader assetLoader;
+
 // Initialize
 bool init() {
     bool success=true;
@@ -124,6 +148,9 @@ bool init() {
                     cout << "SDL_mixer could not initialize. " << Mix_GetError() << endl;
                     success=false;
                 }
+                else {
+                    audioEnabled=true;
+                }
             }
         }
     }
@@ -131,190 +158,206 @@ bool init() {
     return success;
 }
 
-// Load font + sprites
-bool loadMedia() {
-    bool success=true;
+// Where each sprite sits in its sheet
+void setClips() {
+    // Level corner, top left corner by default
+    blockClips[0]={0, 0, 160, 160};
 
-    gTinyFont=TTF_OpenFont("Resources/AmaticSC-Bold.ttf", 32);
-    gSmallFont=TTF_OpenFont("Resources/AmaticSC-Bold.ttf", 48);
-    gMediumFont=TTF_OpenFont("Resources/AmaticSC-Bold.ttf", 72);
-    gLargeFont=TTF_OpenFont("Resources/AmaticSC-Bold.ttf", 120);
-    gXtraFont=TTF_OpenFont("Resources/AmaticSC-Bold.ttf", 166);
-    if (gSmallFont==nullptr || gMediumFont==nullptr || gLargeFont==nullptr) {
-        cout << "Failed to load font. " << TTF_GetError() << endl;
-        success=false;
-    }
-    else {
-        if (!instructionTexture[0].setTextOnce("Press any key to start", textColor, gMediumFont) ||
-            !instructionTexture[1].setTextOnce("Press left/right to customize background", textColor, gMediumFont) ||
-            !instructionTexture[2].setTextOnce("Press left/right to customize color", textColor, gMediumFont) ||
-            !instructionTexture[3].setTextOnce("Press up/down to select settings", textColor, gMediumFont) ||
-            !instructionTexture[4].setTextOnce("Press Enter to finish", textColor, gMediumFont) ||
+    // Wall block, horizontal by default
+    blockClips[1]={160, 0, 160, 160};
 
-            !instructionTexture[10].setTextOnce("Press R to restart, ESC to exit", textColor, gMediumFont) ||
+    // T-block, wall side facing left by default
+    blockClips[2]={0, 160, 160, 160};
 
-            !gameTitleTexture.setTextOnce("Die to Win", textColor, gXtraFont) ||
-            !winMsgTexture.setTextOnce("Congratulations", textColor, gLargeFont)) {
-            cout << "Failed to render text texture." << endl;
-            success=false;
-        }
-    }
+    // Platform tip block, facing up by default
+    blockClips[3]={160, 160, 160, 160};
 
-    if (!blockSheetTexture.loadFromFile("Resources/Block and Spike.png")) {
-        cout << "Failed to load block and spike texture." << endl;
-        success=false;
-    }
-    else {
-        // Level corner, top left corner by default
-        blockClips[0]={0, 0, 160, 160};
+    // No border block
+    blockClips[4]={0, 320, 160, 160};
 
-        // Wall block, horizontal by default
-        blockClips[1]={160, 0, 160, 160};
+    // All border block
+    blockClips[5]={160, 320, 160, 160};
 
-        // T-block, wall side facing left by default
-        blockClips[2]={0, 160, 160, 160};
+    // Idle tycoon block 1 - misc upgrade
+    blockClips[6]={0, 480, 160, 160};
 
-        // Platform tip block, facing up by default
-        blockClips[3]={160, 160, 160, 160};
+    // Idle tycoon block 2 - lower the point block
+    blockClips[7]={160, 480, 160, 160};
 
-        // No border block
-        blockClips[4]={0, 320, 160, 160};
+    // Idle tycoon block 3 - point upgrade
+    blockClips[8]={320, 480, 160, 160};
 
-        // All border block
-        blockClips[5]={160, 320, 160, 160};
+    // Idle tycoon block 4 - passive income upgrade
+    blockClips[9]={480, 480, 160, 160};
 
-        // Idle tycoon block 1 - misc upgrade
-        blockClips[6]={0, 480, 160, 160};
+    // Idle tycoon - point block
+    blockClips[10]={640, 480, 160, 160};
 
-        // Idle tycoon block 2 - lower the point block
-        blockClips[7]={160, 480, 160, 160};
+    // Menu block 1 - settings
+    blockClips[11]={0, 640, 160, 160};
 
-        // Idle tycoon block 3 - point upgrade
-        blockClips[8]={320, 480, 160, 160};
+    // Menu block 2 - start
+    blockClips[12]={160, 640, 160, 160};
 
-        // Idle tycoon block 4 - passive income upgrade
-        blockClips[9]={480, 480, 160, 160};
+    // Menu block 3 - credits
+    blockClips[13]={320, 640, 160, 160};
 
-        // Idle tycoon - point block
-        blockClips[10]={640, 480, 160, 160};
+    // Password puzzle - check solution
+    blockClips[14]={0, 800, 160, 160};
 
-        // Menu block 1 - settings
-        blockClips[11]={0, 640, 160, 160};
+    // Pool puzzle - add water
+    blockClips[15]={160, 800, 160, 160};
 
-        // Menu block 2 - start
-        blockClips[12]={160, 640, 160, 160};
+    // Time puzzle - stop time
+    blockClips[16]={320, 800, 160, 160};
 
-        // Menu block 3 - credits
-        blockClips[13]={320, 640, 160, 160};
+    // Movable block
+    blockClips[17]={480, 640, 320, 320};
 
-        // Password puzzle - check solution
-        blockClips[14]={0, 800, 160, 160};
+    // Tic-tac-toe puzzle - move X to next position
+    blockClips[18]={1280, 0, 160, 160};
 
-        // Pool puzzle - add water
-        blockClips[15]={160, 800, 160, 160};
+    // Tic-tac-toe puzzle - X block (interactable)
+    // Tic-tac-toe puzzle - X block
+    blockClips[19]={1440, 0, 160, 160};
 
-        // Time puzzle - stop time
-        blockClips[16]={320, 800, 160, 160};
+    // Tic-tac-toe puzzle - O block
+    blockClips[20]={1600, 0, 160, 160};
 
-        // Movable block
-        blockClips[17]={480, 640, 320, 320};
+    // Reset puzzle
+    blockClips[21]={1760, 0, 160, 160};
 
-        // Tic-tac-toe puzzle - move X to next position
-        blockClips[18]={1280, 0, 160, 160};
+    // Electricity puzzle - deplete
+    blockClips[22]={1760, 160, 160, 160};
 
-        // Tic-tac-toe puzzle - X block (interactable)
-        // Tic-tac-toe puzzle - X block
-        blockClips[19]={1440, 0, 160, 160};
+    // Corner block, top left corner by default
+    blockClips[23]={320, 320, 160, 160};
 
-        // Tic-tac-toe puzzle - O block
-        blockClips[20]={1600, 0, 160, 160};
+    // Line block, facing up by default
+    blockClips[24]={480, 320, 160, 160};
 
-        // Reset puzzle
-        blockClips[21]={1760, 0, 160, 160};
+    // Platform tip with spike on top, platform tip facing left, spike facing up by default
+    blockClips[25]={320, 160, 160, 160};
+    spikeClips[0]={320, 0, 160, 160};
 
-        // Electricity puzzle - deplete
-        blockClips[22]={1760, 160, 160, 160};
+    // Platform with spike on top, spike facing up by default
+    blockClips[26]={480, 160, 160, 160};
+    spikeClips[1]={480, 0, 160, 160};
 
-        // Corner block, top left corner by default
-        blockClips[23]={320, 320, 160, 160};
+    // Platform with big spike on top, spike facing up by default
+    blockClips[27]={640, 160, 160, 160};
+    spikeClips[2]={640, 0, 160, 160};
 
-        // Line block, facing up by default
-        blockClips[24]={480, 320, 160, 160};
+    // Jump-through platforms
+    blockClips[28]={1440, 160, 160, 160};
+    blockClips[29]={1600, 160, 160, 160};
 
-        // Platform tip with spike on top, platform tip facing left, spike facing up by default
-        blockClips[25]={320, 160, 160, 160};
-        spikeClips[0]={320, 0, 160, 160};
+    // Invisible block
+    blockClips[30]={1280, 320, 160, 160};
 
-        // Platform with spike on top, spike facing up by default
-        blockClips[26]={480, 160, 160, 160};
-        spikeClips[1]={480, 0, 160, 160};
+    orbClips[0]={0, 0, 160, 160};       // Yellow orb
+    orbClips[1]={160, 0, 160, 160};     // Blue orb
+    orbClips[2]={320, 0, 160, 160};     // Green orb
+    orbClips[3]={480, 0, 160, 160};     // Dash orb
 
-        // Platform with big spike on top, spike facing up by default
-        blockClips[27]={640, 160, 160, 160};
-        spikeClips[2]={640, 0, 160, 160};
+    padClips[0]={0, 160, 160, 160};     // Yellow pad
+    padClips[1]={160, 160, 160, 160};   // Spider pad
+    padClips[2]={320, 160, 160, 160};   // Pink pad
+}
 
-        // Jump-through platforms
-        blockClips[28]={1440, 160, 160, 160};
-        blockClips[29]={1600, 160, 160, 160};
+// Minimal loading screen, nothing but a progress bar since the fonts may not be in yet
+void renderLoadingScreen(float progress) {
+    SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 0xFF);
+    SDL_RenderClear(gRenderer);
+    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_FRect outline={SCREEN_WIDTH/4.0f, SCREEN_HEIGHT/2.0f-TILE_SIZE/8.0f, SCREEN_WIDTH/2.0f, TILE_SIZE/4.0f};
+    SDL_FRect bar={outline.x+4, outline.y+4, (outline.w-8)*progress, outline.h-8};
+    SDL_RenderDrawRectF(gRenderer, &outline);
+    SDL_RenderFillRectF(gRenderer, &bar);
+    SDL_RenderPresent(gRenderer);
+}
 
-        // Invisible block
-        blockClips[30]={1280, 320, 160, 160};
+// Load font + sprites
+// Files are decoded on worker threads, this returns once the menu has what it needs and the rest keeps loading
+bool loadMedia() {
+    bool success=true;
+    setClips();
+
+    assetLoader.addFont(&gTinyFont, "Resources/AmaticSC-Bold.ttf", 32, ASSETS_MENU);
+    assetLoader.addFont(&gSmallFont, "Resources/AmaticSC-Bold.ttf", 48, ASSETS_MENU);
+    assetLoader.addFont(&gMediumFont, "Resources/AmaticSC-Bold.ttf", 72, ASSETS_MENU);
+    assetLoader.addFont(&gLargeFont, "Resources/AmaticSC-Bold.ttf", 120, ASSETS_MENU);
+    assetLoader.addFont(&gXtraFont, "Resources/AmaticSC-Bold.ttf", 166, ASSETS_MENU);
+    assetLoader.addImage(&blockSheetTexture, "Resources/Block and Spike.png", ASSETS_MENU);
+    assetLoader.addImage(&cubeTexture, "Resources/Player.png", ASSETS_MENU);
+    assetLoader.addImage(&orbPadSheetTexture, "Resources/Orb and Pad.png", ASSETS_MENU);
+    assetLoader.addImage(&backgroundTexture[STRIPE], "Resources/Stripe BG.png", ASSETS_MENU);
+    assetLoader.addImage(&backgroundTexture[TETRIS], "Resources/Tetris BG.png", ASSETS_MENU);
+    assetLoader.addImage(&backgroundTexture[BLANK], "Resources/Blank BG.png", ASSETS_MENU);
+    assetLoader.addMusic(&gameThemeSong, "Resources/Game Theme.ogg", ASSETS_MENU); // The menu starts the theme
+
+    assetLoader.addImage(&toBeContinued, "Resources/To Be Continued.png", ASSETS_LEVELS);
+    assetLoader.addMusic(&fnafSong, "Resources/FNAF Song.mp3", ASSETS_LEVELS);
+    assetLoader.addMusic(&jojoSong, "Resources/Roundabout.mp3", ASSETS_LEVELS);
+    assetLoader.addSound(&deathSound, "Resources/Death Sound.mp3", ASSETS_LEVELS);
+    assetLoader.start();
+
+    // Show progress until the menu can be drawn, a quit request is kept for the game loop
+    bool quitRequested=false;
+    while (!assetLoader.groupReady(ASSETS_MENU)) {
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) {
+            if (e.type==SDL_QUIT) quitRequested=true;
+        }
+        assetLoader.poll();
+        renderLoadingScreen(assetLoader.progress());
+        SDL_Delay(1);
     }
-
-    if (!cubeTexture.loadFromFile("Resources/Player.png")) {
-        cout << "Failed to load cube texture." << endl;
+    if (quitRequested) {
+        SDL_Event quitEvent={};
+        quitEvent.type=SDL_QUIT;
+        SDL_PushEvent(&quitEvent);
+    }
+    if (assetLoader.failed()) {
+        cout << "Failed to load menu assets." << endl;
         success=false;
     }
 
-    if (!orbPadSheetTexture.loadFromFile("Resources/Orb and Pad.png")) {
-        cout << "Failed to load orb and pad texture." << endl;
+    if (gTinyFont==nullptr || gSmallFont==nullptr || gMediumFont==nullptr || gLargeFont==nullptr || gXtraFont==nullptr) {
+        cout << "Failed to load font. " << TTF_GetError() << endl;
         success=false;
     }
     else {
-        orbClips[0]={0, 0, 160, 160};       // Yellow orb
-        orbClips[1]={160, 0, 160, 160};     // Blue orb
-        orbClips[2]={320, 0, 160, 160};     // Green orb
-        orbClips[3]={480, 0, 160, 160};     // Dash orb
-
-        padClips[0]={0, 160, 160, 160};     // Yellow pad
-        padClips[1]={160, 160, 160, 160};   // Spider pad
-        padClips[2]={320, 160, 160, 160};   // Pink pad
-    }
+        // Rasterize the screen text up front so the first frames don't have to
+        if (textCache.acquire("Press left/right to customize background", gMediumFont, textColor).index<0 ||
+            textCache.acquire("Press left/right to customize color", gMediumFont, textColor).index<0 ||
+            textCache.acquire("Press up/down to select settings", gMediumFont, textColor).index<0 ||
+            textCache.acquire("Press Enter to finish", gMediumFont, textColor).index<0 ||
 
-    if (!backgroundTexture[STRIPE].loadFromFile("Resources/Stripe BG.png") ||
-        !backgroundTexture[TETRIS].loadFromFile("Resources/Tetris BG.png") ||
-        !backgroundTexture[BLANK].loadFromFile("Resources/Blank BG.png")) {
+            textCache.acquire("Press R to restart, ESC to exit", gMediumFont, textColor).index<0 ||
 
-        cout << "Failed to load background texture." << endl;
-        success=false;
-    }
-
-    if (!toBeContinued.loadFromFile("Resources/To Be Continued.png")) {
-        cout << "Failed to load meme arrow texture." << endl;
-        success=false;
+            textCache.acquire("Die to Win", gXtraFont, textColor).index<0 ||
+            textCache.acquire("Congratulations", gLargeFont, textColor).index<0) {
+            cout << "Failed to render text texture." << endl;
+            success=false;
+        }
+        if (!tinyText.load(gTinyFont, textColor) || !smallText.load(gSmallFont, textColor) ||
+            !mediumText.load(gMediumFont, textColor) || !largeText.load(gLargeFont, textColor) ||
+            !xtraText.load(gXtraFont, textColor)) {
+            cout << "Failed to build glyph atlas." << endl;
+            success=false;
+        }
     }
 
-    gameThemeSong=Mix_LoadMUS("Resources/Game Theme.ogg");
-    if (gameThemeSong==nullptr) {
-        cout << "Failed to load game theme song. " << Mix_GetError() << endl;
-        success=false;
-    }
-    fnafSong=Mix_LoadMUS("Resources/FNAF Song.mp3");
-    jojoSong=Mix_LoadMUS("Resources/Roundabout.mp3");
-    if (fnafSong==nullptr || jojoSong==nullptr) {
-        cout << "Failed to load level song. " << Mix_GetError() << endl;
-        success=false;
-    }
-    deathSound=Mix_LoadWAV("Resources/Death Sound.mp3");
-    if (deathSound==nullptr) {
-        cout << "Failed to load death sound effect. " << Mix_GetError() << endl;
-        success=false;
-    }
     return success;
 }
 
 // Cleanup
 void close() {
+    // Nothing may still be loading into what gets freed below
+    assetLoader.stop();
+    clearLevelCache();
+
     // Deal with music + SFX
     Mix_FreeMusic(gameThemeSong);
     gameThemeSong=nullptr;
@@ -334,11 +377,12 @@ void close() {
         backgroundTexture[i].free();
     }
 
-    for (int i=0; i<100; i++) {
-        instructionTexture[i].free();
-    }
-    gameTitleTexture.free();
-    winMsgTexture.free();
+    textCache.clear();
+    tinyText.free();
+    smallText.free();
+    mediumText.free();
+    largeText.free();
+    xtraText.free();
 
     // Deal with fonts
     TTF_CloseFont(gTinyFont);
@@ -353,6 +397,7 @@ void close() {
     gXtraFont=nullptr;
 
     // Deal with window & renderer
+    freeStaticLayer();
     SDL_DestroyRenderer(gRenderer);
     gRenderer=nullptr;
     SDL_DestroyWindow(gWindow);
@@ -365,142 +410,128 @@ void close() {
     SDL_Quit();
 }
 
-void offsetPosition(vector<Block> &blocks, const string &levelName) {
-    if (levelName=="Tic Tac Toe") {
-        for (auto &block : blocks) {
-            if (block.getType()=="1XM") block.offsetPosition(TILE_SIZE/2, 0);
-        }
-    }
-}
-
-void displayTextInLevel(Player cube, vector<Block> &blocks, GameStatus currentStatus, GameSetting currentSetting,
+void displayTextInLevel(Player &cube, vector<Block> &blocks, GameStatus currentStatus, GameSetting currentSetting,
                         const string &levelName, const int &levelIndex) {
+    PROFILE_SCOPE(ZONE_TEXT);
+    char text[TEXT_BUFFER_SIZE];
 
     if (currentStatus==MENU) {
-        instructionTexture[14].setTextOnce("Menu", textColor, gTinyFont);
-        instructionTexture[14].render(4, -4);
-        instructionTexture[14].render(SCREEN_WIDTH-instructionTexture[14].getWidth()-4, -4);
+        tinyText.render("Menu", 4, -4);
+        tinyText.render("Menu", SCREEN_WIDTH-tinyText.getWidth("Menu")-4, -4);
 
         for (const Block &block : blocks) {
-            if (block.getType()=="1S") {
-                instructionTexture[30].setTextOnce("Settings", textColor, gMediumFont);
-                instructionTexture[30].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[30].getWidth())/2,
-                                               block.getHitbox().y-instructionTexture[30].getHeight());
+            const char *label=nullptr;
+            if (block.getType()==TILE_1S) label="Settings";
+            if (block.getType()==TILE_1P) label="Play";
+            if (block.getType()==TILE_1C) label="Credits";
+            if (label!=nullptr) {
+                mediumText.render(label, block.getHitbox().x+(block.getHitbox().w-mediumText.getWidth(label))/2,
+                                  block.getHitbox().y-mediumText.getHeight());
             }
-            if (block.getType()=="1P") {
-                instructionTexture[30].setTextOnce("Play", textColor, gMediumFont);
-                instructionTexture[30].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[30].getWidth())/2,
-                                               block.getHitbox().y-instructionTexture[30].getHeight());
+            if (block.getType()==TILE_1K0) {
+                LTexture &title=textCache.get("Die to Win", gXtraFont, textColor);
+                title.render(block.getHitbox().x+(9*TILE_SIZE-title.getWidth())/2, block.getHitbox().y);
             }
-            if (block.getType()=="1C") {
-                instructionTexture[30].setTextOnce("Credits", textColor, gMediumFont);
-                instructionTexture[30].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[30].getWidth())/2,
-                                               block.getHitbox().y-instructionTexture[30].getHeight());
-            }
-            if (block.getType()=="1K0") {
-                gameTitleTexture.render(block.getHitbox().x+(9*TILE_SIZE-gameTitleTexture.getWidth())/2, block.getHitbox().y);
-            }
-            if (block.getType()=="1K2") {
-                instructionTexture[30].setTextOnce("v1.0 ", textColor, gSmallFont);
-                instructionTexture[30].render(block.getHitbox().x+block.getHitbox().w-instructionTexture[30].getWidth(),
-                                               block.getHitbox().y+block.getHitbox().h-instructionTexture[30].getHeight());
+            if (block.getType()==TILE_1K2) {
+                smallText.render("v1.0 ", block.getHitbox().x+block.getHitbox().w-smallText.getWidth("v1.0 "),
+                                 block.getHitbox().y+block.getHitbox().h-smallText.getHeight());
             }
         }
     }
 
     else if (currentStatus==PLAYING) {
-        instructionTexture[15].setTextOnce("Level "+to_string(levelIndex), textColor, gTinyFont);
-        instructionTexture[15].render(4, -4);
-        instructionTexture[16].setTextOnce(levelName, textColor, gTinyFont);
-        instructionTexture[16].render(SCREEN_WIDTH-instructionTexture[16].getWidth()-4, -4);
+        formatNumber(text, levelIndex, "Level ");
+        tinyText.render(text, 4, -4);
+        tinyText.render(levelName, SCREEN_WIDTH-tinyText.getWidth(levelName.c_str())-4, -4);
 
         if (levelName=="Cookies") {
-            vector<Block*> textPlat;
-            for (Block &block : blocks) {
-                if (block.getType()=="1IP") {
-                    instructionTexture[20].setTextOnce(to_string(cube.getGainPerHit()), textColor, gSmallFont);
-                    instructionTexture[20].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[20].getWidth())/2,
-                                                  block.getHitbox().y-instructionTexture[20].getHeight()+6);
-                }
-                if (block.getType()=="1I2") {
-                    instructionTexture[20].setTextOnce((block.counter<5 ? to_string(block.value) : "MAX"), textColor, gSmallFont);
-                    instructionTexture[20].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[20].getWidth())/2,
-                                                  block.getHitbox().y-instructionTexture[20].getHeight()+6);
+            const Block *textPlat[2]={};
+            int textPlatCount=0;
+            for (const Block &block : blocks) {
+                const char *price=nullptr;
+                ClickerUpgrade upgrade;
+                bool isUpgrade=clickerUpgrade(block.getType(), upgrade);
+                if (block.getType()==TILE_1IP) price=formatMoney(text, cube.economy.gainPerHit);
+                if (isUpgrade) {
+                    price=(cube.economy.level[upgrade]<UPGRADE_MAX_LEVEL[upgrade] ? formatMoney(text, cube.economy.price[upgrade]) : "MAX");
                 }
-                if (block.getType()=="1I3" || block.getType()=="1I4") {
-                    instructionTexture[20].setTextOnce((block.counter<25 ? to_string(block.value) : "MAX"), textColor, gSmallFont);
-                    instructionTexture[20].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[20].getWidth())/2,
-                                                  block.getHitbox().y-instructionTexture[20].getHeight()+6);
+                if (price!=nullptr) {
+                    smallText.render(price, block.getHitbox().x+(block.getHitbox().w-smallText.getWidth(price))/2,
+                                     block.getHitbox().y-smallText.getHeight()+6);
                 }
-                if (block.getType()=="1I2" || block.getType()=="1I3" || block.getType()=="1I4") {
-                    instructionTexture[25].setTextOnce(to_string(block.counter), textColor, gTinyFont);
-                    instructionTexture[25].render(block.getHitbox().x+TILE_SIZE/12, block.getHitbox().y);
+                if (isUpgrade) {
+                    tinyText.render(formatNumber(text, cube.economy.level[upgrade]), block.getHitbox().x+TILE_SIZE/12, block.getHitbox().y);
                 }
-                if (block.getType()=="1PL") {
-                    textPlat.push_back(&block);
+                if (block.getType()==TILE_1PL && textPlatCount<2) {
+                    textPlat[textPlatCount++]=&block;
                 }
             }
-            instructionTexture[21].loadFromRenderedText(to_string(cube.getTotalMoney()), textColor, gMediumFont);
-            instructionTexture[21].render(textPlat[0]->getHitbox().x+(TILE_SIZE*5-instructionTexture[21].getWidth())/2,
-                                          textPlat[0]->getHitbox().y+(TILE_SIZE-instructionTexture[21].getHeight())/2);
-
-            instructionTexture[22].setTextOnce(to_string(cube.getPassiveIncome())+" /sec", textColor, gMediumFont);
-            instructionTexture[22].render(textPlat[1]->getHitbox().x+(TILE_SIZE*5-instructionTexture[22].getWidth())/2,
-                                          textPlat[1]->getHitbox().y+(TILE_SIZE-instructionTexture[22].getHeight())/2);
-
-            textPlat.clear();
+            if (textPlatCount==2) {
+                formatMoney(text, cube.economy.money);
+                mediumText.render(text, textPlat[0]->getHitbox().x+(TILE_SIZE*5-mediumText.getWidth(text))/2,
+                                  textPlat[0]->getHitbox().y+(TILE_SIZE-mediumText.getHeight())/2);
+
+                formatMoney(text, cube.economy.passiveIncome, "", " /sec");
+                mediumText.render(text, textPlat[1]->getHitbox().x+(TILE_SIZE*5-mediumText.getWidth(text))/2,
+                                  textPlat[1]->getHitbox().y+(TILE_SIZE-mediumText.getHeight())/2);
+            }
         }
 
         else if (levelName=="Enigma") {
-            for (Block &block : blocks) {
-                if (block.getType()=="1BG" || block.getType()=="1BO" || block.getType()=="1BI") {
-                    instructionTexture[40].loadFromRenderedText(to_string(block.counter), textColor, gMediumFont);
-                    instructionTexture[40].render(block.getHitbox().x+(block.getHitbox().w-instructionTexture[40].getWidth())/2,
-                                                  block.getHitbox().y+(block.getHitbox().h-instructionTexture[40].getHeight())/2);
-                }
-                if (!uniqueDigitsInPassword) {
-                    instructionTexture[41].setTextOnce("Password should contain 4 different digits", textColor, gMediumFont);
-                    instructionTexture[41].render((SCREEN_WIDTH-instructionTexture[41].getWidth())/2, SCREEN_HEIGHT/2);
+            for (const Block &block : blocks) {
+                if (block.hasFlag(FLAG_ENIGMA_DISPLAY)) {
+                    formatNumber(text, block.counter);
+                    mediumText.render(text, block.getHitbox().x+(block.getHitbox().w-mediumText.getWidth(text))/2,
+                                      block.getHitbox().y+(block.getHitbox().h-mediumText.getHeight())/2);
                 }
             }
+            if (!uniqueDigitsInPassword) {
+                const char *warning="Password should contain 4 different digits";
+                mediumText.render(warning, (SCREEN_WIDTH-mediumText.getWidth(warning))/2, SCREEN_HEIGHT/2);
+            }
+            else if (enigmaHints && enigmaSolver.remaining()<ENIGMA_CODES) {
+                EnigmaCode hint=enigmaSolver.bestGuess();
+                snprintf(text, sizeof(text), "%d possible, try %d%d%d%d", enigmaSolver.remaining(),
+                         enigmaDigit(hint, 0), enigmaDigit(hint, 1), enigmaDigit(hint, 2), enigmaDigit(hint, 3));
+                smallText.render(text, (SCREEN_WIDTH-smallText.getWidth(text))/2, SCREEN_HEIGHT/2);
+            }
         }
 
         else if (levelName=="Illusion World") {
             if (cube.timeStopped) {
-                instructionTexture[45].loadFromRenderedText(to_string(int(cube.timeStopTimer)+1), textColor, gXtraFont);
-                instructionTexture[45].setAlpha(100);
-                instructionTexture[45].render((SCREEN_WIDTH-instructionTexture[45].getWidth())/2, (SCREEN_HEIGHT-instructionTexture[45].getHeight())/2);
+                formatNumber(text, int(cube.timeStopTimer)+1);
+                xtraText.render(text, (SCREEN_WIDTH-xtraText.getWidth(text))/2, (SCREEN_HEIGHT-xtraText.getHeight())/2, 100);
             }
         }
 
         else if (levelName=="Five Nights") {
             for (const Block &block : blocks) {
-                if (block.getType()=="1PL") {
-                    instructionTexture[46].loadFromRenderedText(to_string(cube.powerPercent)+" %", textColor, gMediumFont);
-                    instructionTexture[46].render(TILE_SIZE/2+block.getHitbox().x+(block.getHitbox().w-instructionTexture[46].getWidth())/2,
-                                                  block.getHitbox().y+(block.getHitbox().h-instructionTexture[46].getHeight())/2);
+                if (block.getType()==TILE_1PL) {
+                    formatNumber(text, cube.powerPercent, "", " %");
+                    mediumText.render(text, TILE_SIZE/2+block.getHitbox().x+(block.getHitbox().w-mediumText.getWidth(text))/2,
+                                      block.getHitbox().y+(block.getHitbox().h-mediumText.getHeight())/2);
                 }
             }
         }
         else if (levelName=="Tic Tac Toe") {
-            if (playerWins) {
-                instructionTexture[47].setTextOnce("Player wins", textColor, gLargeFont);
-                instructionTexture[47].render((SCREEN_WIDTH-instructionTexture[47].getWidth())/2, TILE_SIZE/2);
-            }
-            else if (botWins) {
-                instructionTexture[47].setTextOnce("Bot wins", textColor, gLargeFont);
-                instructionTexture[47].render((SCREEN_WIDTH-instructionTexture[47].getWidth())/2, TILE_SIZE/2);
-            }
-            else if (stalemate) {
-                instructionTexture[47].setTextOnce("Draw", textColor, gLargeFont);
-                instructionTexture[47].render((SCREEN_WIDTH-instructionTexture[47].getWidth())/2, TILE_SIZE/2);
-            }
+            const char *result=nullptr;
+            if (ticTacToe.result()==TTT_X_WINS) result="Player wins";
+            else if (ticTacToe.result()==TTT_O_WINS) result="Bot wins";
+            else if (ticTacToe.result()==TTT_DRAW) result="Draw";
+            if (result!=nullptr) largeText.render(result, (SCREEN_WIDTH-largeText.getWidth(result))/2, TILE_SIZE/2);
         }
         else if (levelName=="The End") {
-            instructionTexture[60].setTextOnce("Thank you for playing!", textColor, gLargeFont);
-            instructionTexture[60].render((SCREEN_WIDTH-instructionTexture[60].getWidth())/2, TILE_SIZE/2);
+            const char *thanks="Thank you for playing!";
+            largeText.render(thanks, (SCREEN_WIDTH-largeText.getWidth(thanks))/2, TILE_SIZE/2);
         }
     }
+
+    // One draw call per font
+    tinyText.flush();
+    smallText.flush();
+    mediumText.flush();
+    largeText.flush();
+    xtraText.flush();
 }
 
 const int ALL_LEVELS=17;
@@ -510,43 +541,134 @@ string levelName[ALL_LEVELS]={"The Hub",
                               "Tic Tac Toe", "Vertigo", "The End"};
 static int levelIndex=1;
 
+// Fade between levels after a death
+const double LEVEL_TRANSITION_TIME=1.0;
+
 int main(int argc, char *argv[]) {
+    // Level compiler, no window needed
+    if (argc>=2 && string(argv[1])=="--compile-levels") {
+        return compileAllLevels();
+    }
+    if (argc>=4 && string(argv[1])=="--compile-level") {
+        return compileLevel(argv[2], argv[3]) ? 0 : 1;
+    }
+    // Game logic only, no window or audio device
+    if (argc>=2 && string(argv[1])=="--headless") {
+        return runHeadless(argc, argv);
+    }
+    if (argc>=3 && string(argv[1])=="--replay-fast") {
+        return runHeadlessReplay(argv[2]);
+    }
+    // Engine self tests, every one or the one named
+    if (argc>=2 && string(argv[1])=="--self-test") {
+        return runSelfTests(argc>=3 ? argv[2] : "");
+    }
+    // Level solver, every level in parallel or one level in this process
+    if (argc>=2 && string(argv[1])=="--solve-levels") {
+        return runSolverAll(argv[0], argc>=3 ? argv[2] : ".", argc>=4 ? strtoul(argv[3], nullptr, 10) : 1);
+    }
+    if (argc>=4 && string(argv[1])=="--solve-level") {
+        return runSolver(argv[2], argv[3], argc>=5 ? strtoul(argv[4], nullptr, 10) : 1);
+    }
+
+    // Game options, each followed by its value
+    string recordPath="", replayPath="", tracePath="";
+    int traceFrames=DEFAULT_TRACE_FRAMES;
+    for (int i=1; i+1<argc; i+=2) {
+        string option=argv[i];
+        if (option=="--tick-rate") {
+            int rate=atoi(argv[i+1]);
+            if (rate>=30 && rate<=1000) tickRate=rate;
+            else cout << "Tick rate must be between 30 and 1000, using " << tickRate << "." << endl;
+        }
+        else if (option=="--pacing") {
+            if (!parsePacingMode(argv[i+1], pacingMode)) cout << "Pacing must be vsync, cap or unlimited." << endl;
+        }
+        else if (option=="--fps") {
+            int fps=atoi(argv[i+1]);
+            if (fps>=30 && fps<=1000) frameCap=fps;
+            else cout << "Frame cap must be between 30 and 1000, using the refresh rate." << endl;
+        }
+        else if (option=="--bot") {
+            if (!parseBotDifficulty(argv[i+1], botDifficulty)) cout << "Bot must be random, easy, hard or perfect." << endl;
+        }
+        else if (option=="--enigma-hints") enigmaHints=(string(argv[i+1])=="on");
+        else if (option=="--record") recordPath=argv[i+1];
+        else if (option=="--replay") replayPath=argv[i+1];
+        else if (option=="--trace") tracePath=argv[i+1];
+        else if (option=="--trace-frames") {
+            int frames=atoi(argv[i+1]);
+            if (frames>0) traceFrames=frames;
+            else cout << "Trace frames must be positive, using " << traceFrames << "." << endl;
+        }
+    }
+#ifndef DTW_PROFILING
+    if (tracePath!="") cout << "Tracing needs a build with DTW_PROFILING, no trace will be written." << endl;
+#endif
+
+    int exitCode=0;
     if (!init()) {
         cout << "Failed to initialize." << endl;
     }
     else {
+        // Started before loading so the asset loads are in the trace
+        if (tracePath!="") PROFILE_START_TRACE(tracePath, traceFrames);
         if (!loadMedia()) {
             cout << "Failed to load media." << endl;
         }
+        else if (argc>=2 && string(argv[1])=="--benchmark") {
+            assetLoader.waitAll();
+            exitCode=runBenchmark(argc, argv);
+        }
         else {
-            // Delta time, to keep physics consistent across all refresh rates
-            Uint64 NOW=SDL_GetPerformanceCounter();
-            Uint64 LAST=0;
+            // Frame time for cosmetic animation, physics runs at the fixed tick rate
             double deltaTime=0;
 
             Player cube;
             static double fadeAlpha=200;
             bool dead=false;
+            double transitionTimer=0;
             float scrollingOffset=0;
             GameStatus currentStatus=MENU;
             GameSetting currentSetting=SETTING_BG;
 
+            // Level currently held in the object vectors, menu and settings are only restored when switching to them
+            string loadedLevelPath="";
+
+            // Replays skip the menu and go straight to the first recorded level
+            if (replayPath!="") {
+                if (startPlayback(replayPath)) currentStatus=START;
+            }
+            else if (recordPath!="") {
+                startRecording(recordPath);
+            }
+
             bool quit=false;
             SDL_Event e;
 
             // Running
+            setPacing(gRenderer, gWindow, pacingMode);
+            resetTimestep();
             while (!quit) {
-                // Calculate delta time
-                LAST=NOW;
-                NOW=SDL_GetPerformanceCounter();
-                deltaTime=double((NOW-LAST)*1000)/SDL_GetPerformanceFrequency();
-                deltaTime/=1000.0; // Convert to seconds
+                deltaTime=beginFrame();
+                GameStatus frameStatus=currentStatus;
+                if (!assetLoader.finished()) assetLoader.poll();
 
                 // Handle game events
+                PROFILE_START(ZONE_EVENTS);
                 while (SDL_PollEvent(&e)) {
                     if (e.type==SDL_QUIT) {
                         quit=true;
                     }
+                    else if (PROFILE_HANDLE_EVENT(e)) {
+                        // Profiler overlay keys
+                    }
+                    else if (e.type==SDL_RENDER_TARGETS_RESET) {
+                        invalidateStaticLayer();
+                    }
+                    else if (e.type==SDL_RENDER_DEVICE_RESET) {
+                        freeStaticLayer();
+                    }
                     else if (currentStatus==SETTINGS && e.type==SDL_KEYDOWN) {
                         switch (e.key.keysym.sym) {
                         case SDLK_UP:
@@ -592,9 +714,95 @@ int main(int argc, char *argv[]) {
                         }
                     }
                     else if (currentStatus==PLAYING || currentStatus==MENU) {
-                        cube.handleEvent(e);
+                        if (!replayControlsInput()) cube.handleEvent(e);
                     }
                 }
+                PROFILE_STOP(ZONE_EVENTS);
+
+                // Fade out, then swap in the next level once its prefetch is done
+                if (currentStatus==TRANSITION) {
+                    transitionTimer+=deltaTime;
+                    if (transitionTimer>=LEVEL_TRANSITION_TIME && levelReady(levelName[levelIndex+1])) {
+                        levelIndex++;
+                        currentStatus=START;
+                    }
+                }
+
+                // Level changes
+                if (currentStatus==START) {
+                    assetLoader.wait(ASSETS_LEVELS); // Normally long done while the menu was up
+                    cube.reset();
+                    unsigned int seed=beginAttempt(levelIndex);
+                    loadedLevelPath=levelPath(levelName[levelIndex]);
+                    startLevel(levelName[levelIndex], seed);
+                    if (levelIndex+1<ALL_LEVELS) prefetchLevel(levelName[levelIndex+1]);
+                    fadeAlpha=0;
+                    currentStatus=PLAYING;
+                }
+
+                // Menu screen
+                if (currentStatus==MENU) {
+                    if (loadedLevelPath!=levelPath("Menu")) {
+                        loadedLevelPath=levelPath("Menu");
+                        restoreLevel(loadedLevelPath, blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
+                        prefetchLevel(levelName[levelIndex]);
+                    }
+                    if (!isMusicPlaying()) playMusic(MUSIC_THEME, -1);
+                }
+
+                // Test level
+                if (currentStatus==TEST) {
+                    loadedLevelPath="Resources/Levels/test.txt";
+                    loadLevel(loadedLevelPath, blocks, pushableBlocks, spikes, jumpOrbs, jumpPads); // Always re-read, for editing levels
+                    currentStatus=PLAYING;
+                }
+
+                // Restart after win
+                if (currentStatus==RESTART) {
+                    dead=false;
+                    fadeAlpha=0;
+                    cube.reset();
+                    levelIndex=1;
+                    unsigned int seed=beginAttempt(levelIndex);
+                    loadedLevelPath=levelPath(levelName[levelIndex]);
+                    startLevel(levelName[levelIndex], seed);
+                    prefetchLevel(levelName[levelIndex+1]);
+                    currentStatus=PLAYING;
+                }
+
+                // Switching to a simulated screen (level loaded, back from settings, credits or the win screen) starts
+                // the clock over, neither the load nor the time on a screen without ticks is simulated as a burst
+                bool entered=(currentStatus==PLAYING || currentStatus==MENU) && currentStatus!=frameStatus;
+                if (entered) resetTimestep();
+
+                // Time the ticks dropped goes to levels that run on their own, unless replays need every tick to match
+                // Only time dropped while the level was already running counts, not the load or the screen before it
+                if (currentStatus==PLAYING && !entered && !recordingReplay && !playingReplay) {
+                    currentBehavior->catchUp(cube, droppedTime());
+                }
+
+                // Simulation, fixed ticks until it catches up with real time
+                while ((currentStatus==PLAYING || currentStatus==MENU) && nextTick()) {
+                    GameStatus tickStatus=currentStatus;
+                    if (currentStatus==PLAYING) replayTick(cube);
+                    simulateTick(cube, currentStatus, dead, tickLength());
+                    if (tickStatus==PLAYING && (dead || currentStatus!=PLAYING)) endAttempt(cube);
+                    if (dead) {
+                        playSound(SOUND_DEATH);
+                        if (levelIndex+1<ALL_LEVELS) {
+                            dead=false;
+                            transitionTimer=0;
+                            currentStatus=TRANSITION;
+                        }
+                        else {
+                            levelIndex++;
+                            currentStatus=WIN;
+                        }
+                        break;
+                    }
+                    if (currentStatus!=tickStatus) break; // Menu choice, next screen starts next frame
+                }
+
                 // Render level
                 scrollingOffset+=60*deltaTime;
                 if (scrollingOffset>SCREEN_HEIGHT) {
@@ -623,65 +831,20 @@ int main(int argc, char *argv[]) {
                     backgroundTexture[selectedBG].render(backgroundRect);
                 }
 
-                renderLevel(blocks, pushableBlocks, spikes, jumpOrbs, jumpPads, deltaTime);
-                cube.render();
-                displayTextInLevel(cube, blocks, currentStatus, currentSetting, levelName[levelIndex], levelIndex);
-
-                if (currentStatus==START) {
-                    Mix_PlayMusic(gameThemeSong, -1);
-                    cube.reset();
-                    loadLevel("Resources/Levels/"+levelName[levelIndex]+".txt", blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
-                    offsetPosition(blocks, levelName[levelIndex]);
-                    fadeAlpha=0;
-                    currentStatus=PLAYING;
-                }
-
-                // Playing
-                if (currentStatus==PLAYING) {
-                    // Handle player interactions
-                    if (!cube.levelFreeze) cube.move(blocks, pushableBlocks, spikes, jumpOrbs, currentStatus, levelName[levelIndex], deltaTime);
-                    cube.interact(blocks, pushableBlocks, spikes, jumpOrbs, jumpPads, levelName[levelIndex], deltaTime, dead);
-                    for (auto &block : pushableBlocks) {
-                        if (!cube.timeStopped) block.update(blocks, cube.getHitbox(), cube.moveLeft, cube.moveRight, dead, deltaTime);
-                    }
-                    if (dead) {
-                        Mix_PlayChannel(-1, deathSound, 0);
-                        levelIndex++;
-                        if (levelIndex<ALL_LEVELS) {
-                            dead=false;
-                            currentStatus=START;
-                            SDL_Delay(1000);
-                        }
-                        else {
-                            currentStatus=WIN;
-                        }
-                    }
-                }
+                double alpha=(currentStatus==TRANSITION ? 1.0 : tickAlpha()); // No ticks run during the fade
+                renderLevel(blocks, pushableBlocks, spikes, jumpOrbs, jumpPads, alpha);
+                cube.render(alpha);
+                GameStatus shownStatus=(currentStatus==TRANSITION ? PLAYING : currentStatus); // The level stays up while it fades
+                displayTextInLevel(cube, blocks, shownStatus, currentSetting, levelName[levelIndex], levelIndex);
+                if (shownStatus==PLAYING) renderLevelOverlay(cube, levelName[levelIndex]);
 
-                // Menu screen
-                if (currentStatus==MENU) {
-                    loadLevel("Resources/Levels/Menu.txt", blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
-                    if (!Mix_PlayingMusic()) Mix_PlayMusic(gameThemeSong, -1);
-                    cube.move(blocks, pushableBlocks, spikes, jumpOrbs, currentStatus, levelName[levelIndex], deltaTime);
-                }
-
-                // Test level
-                if (currentStatus==TEST) {
-                    loadLevel("Resources/Levels/test.txt", blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
-                    currentStatus=PLAYING;
+                if (currentStatus==TRANSITION) {
+                    SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
+                    SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, static_cast<Uint8>(255*min(1.0, transitionTimer/LEVEL_TRANSITION_TIME)));
+                    SDL_FRect fadeOverlay={0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+                    SDL_RenderFillRectF(gRenderer, &fadeOverlay);
                 }
 
-                // Restart after win
-                if (currentStatus==RESTART) {
-                    dead=false;
-                    fadeAlpha=0;
-                    Mix_PlayMusic(gameThemeSong, -1);
-                    cube.reset();
-                    levelIndex=1;
-                    loadLevel("Resources/Levels/"+levelName[levelIndex]+".txt", blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
-                    currentStatus=PLAYING;
-                    continue;
-                }
 
                 // Credits
                 if (currentStatus==CREDITS) {
@@ -694,46 +857,51 @@ int main(int argc, char *argv[]) {
                     SDL_FRect dimOverlay={TILE_SIZE*7/18, textPosY, SCREEN_WIDTH-TILE_SIZE*14/18, SCREEN_HEIGHT-TILE_SIZE};
                     SDL_RenderFillRectF(gRenderer, &dimOverlay);
 
-                    instructionTexture[90].setTextOnce("Special thanks to", textColor, gLargeFont);
-                    instructionTexture[90].render((SCREEN_WIDTH-instructionTexture[90].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[90].getHeight();
-                    instructionTexture[91].setTextOnce("RobTop Games, creator of Geometry Dash", textColor, gMediumFont);
-                    instructionTexture[91].render((SCREEN_WIDTH-instructionTexture[91].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[91].getHeight();
-                    instructionTexture[92].setTextOnce("Lazy Foo Productions", textColor, gMediumFont);
-                    instructionTexture[92].render((SCREEN_WIDTH-instructionTexture[92].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[92].getHeight();
-                    instructionTexture[93].setTextOnce("GDColon.com", textColor, gMediumFont);
-                    instructionTexture[93].render((SCREEN_WIDTH-instructionTexture[93].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[93].getHeight();
-                    instructionTexture[94].setTextOnce("ChatGPT", textColor, gMediumFont);
-                    instructionTexture[94].render((SCREEN_WIDTH-instructionTexture[94].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[94].getHeight()+TILE_SIZE/2;
-                    instructionTexture[4].render((SCREEN_WIDTH-instructionTexture[4].getWidth())/2, textPosY);
+                    const pair<const char*, TTF_Font*> credits[]={{"Special thanks to", gLargeFont},
+                                                                   {"RobTop Games, creator of Geometry Dash", gMediumFont},
+                                                                   {"Lazy Foo Productions", gMediumFont},
+                                                                   {"GDColon.com", gMediumFont},
+                                                                   {"ChatGPT", gMediumFont}};
+                    for (const auto &line : credits) {
+                        LTexture &text=textCache.get(line.first, line.second, textColor);
+                        text.render((SCREEN_WIDTH-text.getWidth())/2, textPosY);
+                        textPosY+=text.getHeight();
+                    }
+                    textPosY+=TILE_SIZE/2;
+                    LTexture &finish=textCache.get("Press Enter to finish", gMediumFont, textColor);
+                    finish.render((SCREEN_WIDTH-finish.getWidth())/2, textPosY);
                 }
 
                 // Settings screen
                 if (currentStatus==SETTINGS) {
                     cube.resetBool();
-                    loadLevel("Resources/Levels/Settings.txt", blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
+                    if (loadedLevelPath!=levelPath("Settings")) {
+                        loadedLevelPath=levelPath("Settings");
+                        restoreLevel(loadedLevelPath, blocks, pushableBlocks, spikes, jumpOrbs, jumpPads);
+                    }
+
+                    LTexture &selectText=textCache.get("Press up/down to select settings", gMediumFont, textColor);
+                    LTexture &backgroundText=textCache.get("Press left/right to customize background", gMediumFont, textColor);
+                    LTexture &colorText=textCache.get("Press left/right to customize color", gMediumFont, textColor);
+                    LTexture &finish=textCache.get("Press Enter to finish", gMediumFont, textColor);
 
                     float textPosY=TILE_SIZE*9/18;
                     fadeAlpha=200;
                     SDL_SetRenderDrawBlendMode(gRenderer, SDL_BLENDMODE_BLEND);
                     SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, static_cast<Uint8>(fadeAlpha));
-                    SDL_FRect dimOverlay={TILE_SIZE*7/18, textPosY, SCREEN_WIDTH-TILE_SIZE*14/18, 3*instructionTexture[3].getHeight()};
+                    SDL_FRect dimOverlay={TILE_SIZE*7/18, textPosY, SCREEN_WIDTH-TILE_SIZE*14/18, 3*selectText.getHeight()};
                     SDL_RenderFillRectF(gRenderer, &dimOverlay);
 
-                    instructionTexture[3].render((SCREEN_WIDTH-instructionTexture[3].getWidth())/2, textPosY);
-                    textPosY+=instructionTexture[3].getHeight();
+                    selectText.render((SCREEN_WIDTH-selectText.getWidth())/2, textPosY);
+                    textPosY+=selectText.getHeight();
                     if (currentSetting==SETTING_BG) {
-                        instructionTexture[1].render((SCREEN_WIDTH-instructionTexture[1].getWidth())/2, textPosY);
+                        backgroundText.render((SCREEN_WIDTH-backgroundText.getWidth())/2, textPosY);
                     }
                     else if (currentSetting==SETTING_COLOR) {
-                        instructionTexture[2].render((SCREEN_WIDTH-instructionTexture[2].getWidth())/2, textPosY);
+                        colorText.render((SCREEN_WIDTH-colorText.getWidth())/2, textPosY);
                     }
-                    textPosY+=instructionTexture[1].getHeight();
-                    instructionTexture[4].render((SCREEN_WIDTH-instructionTexture[4].getWidth())/2, textPosY);
+                    textPosY+=backgroundText.getHeight();
+                    finish.render((SCREEN_WIDTH-finish.getWidth())/2, textPosY);
                 }
 
                 // Win screen
@@ -750,21 +918,33 @@ int main(int argc, char *argv[]) {
                     SDL_FRect dimOverlay={0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
                     SDL_RenderFillRectF(gRenderer, &dimOverlay);
 
+                    LTexture &winMsgTexture=textCache.get("Congratulations", gLargeFont, textColor);
+                    LTexture &restartText=textCache.get("Press R to restart, ESC to exit", gMediumFont, textColor);
                     SDL_FRect winMsgRect={(SCREEN_WIDTH-winMsgTexture.getWidth())/2,
-                                          (SCREEN_HEIGHT-winMsgTexture.getHeight()-instructionTexture[10].getHeight())/2,
+                                          (SCREEN_HEIGHT-winMsgTexture.getHeight()-restartText.getHeight())/2,
                                           winMsgTexture.getWidth(),
                                           winMsgTexture.getHeight()};
                     winMsgTexture.setAlpha(static_cast<Uint8>(fadeAlpha)*255/200);
                     winMsgTexture.render(winMsgRect);
 
-                    instructionTexture[10].setAlpha(static_cast<Uint8>(fadeAlpha)*255/200);
-                    instructionTexture[10].render((SCREEN_WIDTH-instructionTexture[10].getWidth())/2, winMsgRect.y+winMsgRect.h);
+                    restartText.setAlpha(static_cast<Uint8>(fadeAlpha)*255/200);
+                    restartText.render((SCREEN_WIDTH-restartText.getWidth())/2, winMsgRect.y+winMsgRect.h);
                 }
 
+                PROFILE_OVERLAY(tinyText);
+
+                PROFILE_START(ZONE_PRESENT);
                 SDL_RenderPresent(gRenderer);
+                PROFILE_STOP(ZONE_PRESENT);
+                textCache.trim();
+                paceFrame();
+                PROFILE_END_FRAME();
             }
+            endAttempt(cube); // Keep the attempt that was interrupted by quitting
+            reportPacing();
         }
     }
+    PROFILE_FINISH_TRACE(); // Quit before the traced frames were done
     close();
-    return 0;
+    return exitCode;
 }